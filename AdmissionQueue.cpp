@@ -0,0 +1,103 @@
+#include "AdmissionQueue.h"
+#include <algorithm>
+
+AdmissionQueue::AdmissionQueue()
+    : smallestFirst(false), maxDepth(0), nextSequence(0), peakDepth(0), numAdmitted(0), numRejections(0),
+      totalLatency(0), maxLatency(0), numThrottled(0), throttleTime(0) {}
+
+void AdmissionQueue::configure(const std::string& order, int maxDepth) {
+    smallestFirst = order == "smallest";
+    this->maxDepth = maxDepth > 0 ? maxDepth : 0;
+}
+
+void AdmissionQueue::push(const std::shared_ptr<Process>& process) {
+    Entry entry = { process, nextSequence++, std::chrono::steady_clock::now() };
+    entries.emplace(getKey(entry), entry);
+    peakDepth = std::max(peakDepth, static_cast<int>(entries.size()));
+}
+
+AdmissionQueue::Entry AdmissionQueue::pop() {
+    Entry entry = entries.begin()->second;
+    entries.erase(entries.begin());
+    return entry;
+}
+
+void AdmissionQueue::retry(const Entry& entry) {
+    ++numRejections;
+    entries.emplace(getKey(entry), entry);
+}
+
+void AdmissionQueue::admitted(const Entry& entry) {
+    long long latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - entry.arrivalTime).count();
+    ++numAdmitted;
+    totalLatency += latency;
+    maxLatency = std::max(maxLatency, latency);
+}
+
+std::pair<long long, long long> AdmissionQueue::getKey(const Entry& entry) const {
+    return std::make_pair(smallestFirst ? static_cast<long long>(entry.process->getMemorySize()) : 0, entry.sequence);
+}
+
+bool AdmissionQueue::empty() const {
+    return entries.empty();
+}
+
+bool AdmissionQueue::isFull() const {
+    return maxDepth > 0 && static_cast<int>(entries.size()) >= maxDepth;
+}
+
+int AdmissionQueue::size() const {
+    return static_cast<int>(entries.size());
+}
+
+std::vector<std::shared_ptr<Process>> AdmissionQueue::getProcesses() const {
+    std::vector<std::shared_ptr<Process>> processes;
+    for (const auto& entry : entries) {
+        processes.push_back(entry.second.process);
+    }
+    return processes;
+}
+
+std::string AdmissionQueue::getOrderName() const {
+    return smallestFirst ? "smallest" : "fifo";
+}
+
+int AdmissionQueue::getMaxDepth() const {
+    return maxDepth;
+}
+
+int AdmissionQueue::getPeakDepth() const {
+    return peakDepth;
+}
+
+long long AdmissionQueue::getNumAdmitted() const {
+    return numAdmitted;
+}
+
+long long AdmissionQueue::getNumRejections() const {
+    return numRejections;
+}
+
+long long AdmissionQueue::getAverageLatency() const {
+    return numAdmitted > 0 ? totalLatency / numAdmitted : 0;
+}
+
+long long AdmissionQueue::getMaxLatency() const {
+    return maxLatency;
+}
+
+void AdmissionQueue::recordThrottle() {
+    ++numThrottled;
+}
+
+void AdmissionQueue::recordThrottleTime(long long waitMicroseconds) {
+    throttleTime += waitMicroseconds;
+}
+
+long long AdmissionQueue::getNumThrottled() const {
+    return numThrottled;
+}
+
+long long AdmissionQueue::getThrottleTime() const {
+    return throttleTime;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <chrono>
+#include "Process.h"
+
+// Processes waiting for memory before they reach the scheduler
+// Admitted in arrival order (fifo) or smallest memory first, ties in arrival order. A process that finds no memory
+// goes back to its place and is retried once memory is freed, so it is never dropped or overtaken by a later arrival.
+// The queue holds at most maxDepth processes, whoever creates processes waits for room (backpressure).
+// Not thread-safe, the resource manager guards it with its process lock.
+class AdmissionQueue
+{
+public:
+	struct Entry {
+		std::shared_ptr<Process> process;
+		long long sequence; // arrival order
+		std::chrono::steady_clock::time_point arrivalTime;
+	};
+
+	AdmissionQueue();
+
+	void configure(const std::string& order, int maxDepth); // "fifo" or "smallest", maxDepth 0 is unbounded
+
+	void push(const std::shared_ptr<Process>& process);
+	Entry pop(); // the next process to admit, the queue must not be empty
+	void retry(const Entry& entry); // the popped process found no memory, it goes back to its place
+	void admitted(const Entry& entry); // the popped process reached the scheduler
+
+	bool empty() const;
+	bool isFull() const;
+	int size() const;
+	std::vector<std::shared_ptr<Process>> getProcesses() const; // in admission order
+
+	// Stats
+	std::string getOrderName() const;
+	int getMaxDepth() const; // 0 if unbounded
+	int getPeakDepth() const;
+	long long getNumAdmitted() const;
+	long long getNumRejections() const; // admission attempts that found no memory
+	long long getAverageLatency() const; // microseconds from creation to the scheduler
+	long long getMaxLatency() const;
+	void recordThrottle(); // a creation has to wait for room
+	void recordThrottleTime(long long waitMicroseconds); // once it got room
+	long long getNumThrottled() const;
+	long long getThrottleTime() const; // microseconds creations waited for room
+
+private:
+	bool smallestFirst;
+	int maxDepth;
+	long long nextSequence;
+	std::map<std::pair<long long, long long>, Entry> entries; // (memory size or 0, sequence) -> waiting process
+
+	int peakDepth;
+	long long numAdmitted;
+	long long numRejections;
+	long long totalLatency;
+	long long maxLatency;
+	long long numThrottled;
+	long long throttleTime;
+
+	std::pair<long long, long long> getKey(const Entry& entry) const;
+};
@@ -1,80 +1,526 @@
 #include "BackingStore.h"
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
 
-BackingStore::BackingStore(const std::string& filename) : filename(filename) {
-    openFiles();
+namespace {
+    const uint32_t BACKING_STORE_MAGIC = 0x53425343; // "CSBS"
+    const uint32_t BACKING_STORE_VERSION = 1;
+    const uint32_t INITIAL_RECORD_CAPACITY = 1024;
+    const int32_t EMPTY_PID = -1;
+    const int32_t REMOVED_PID = -2;
+    const uint32_t RECORD_LIVE = 1;
+    const uint32_t MIN_DEAD_RECORDS_TO_COMPACT = 64; // fewer are not worth rewriting the file for
+
+    uint32_t hashPID(int pid) {
+        return static_cast<uint32_t>(pid) * 2654435761u;
+    }
+}
+
+BackingStore::BackingStore(const std::string& filename)
+    : filename(filename), numCompactions(0), numRecordsReclaimed(0), lastCompactionTime(0), lastCompactionPause(0),
+      swapSlotSize(0), numPageWrites(0), numPageWriteRuns(0), numPageReads(0), numPageReadErrors(0) {
+    static_assert(sizeof(Header) == 64 && sizeof(IndexEntry) == 8 && sizeof(Record) == 64, "backing store layout changed");
+
+    if (!file.open(filename, sizeof(Header))) {
+        std::cerr << "Cannot map backing store " << filename << std::endl;
+        return;
+    }
+
+    Header* header = getHeader();
+    if (header->magic != BACKING_STORE_MAGIC || header->version != BACKING_STORE_VERSION || header->recordSize != sizeof(Record)
+        || file.size() < sizeof(Header) + static_cast<size_t>(header->indexCapacity) * sizeof(IndexEntry) + static_cast<size_t>(header->recordCapacity) * sizeof(Record)) {
+        if (header->magic != 0) {
+            std::cerr << filename << " is not a binary backing store, starting an empty one" << std::endl;
+        }
+        format(INITIAL_RECORD_CAPACITY);
+    }
 }
 
 BackingStore::~BackingStore() {
-    closeFiles();
+    file.close();
+    swapFile.close();
 }
 
-void BackingStore::openFiles() {
-    outputFile.open(filename, std::ios::out | std::ios::app);
-    inputFile.open(filename, std::ios::in);
+BackingStore::Header* BackingStore::getHeader() const {
+    return getHeader(file);
 }
 
-void BackingStore::closeFiles() {
-    if (outputFile.is_open()) {
-        outputFile.close();
+BackingStore::IndexEntry* BackingStore::getIndex() const {
+    return getIndex(file);
+}
+
+BackingStore::Record* BackingStore::getRecords() const {
+    return getRecords(file);
+}
+
+BackingStore::Header* BackingStore::getHeader(const MappedFile& target) {
+    return reinterpret_cast<Header*>(target.data());
+}
+
+BackingStore::IndexEntry* BackingStore::getIndex(const MappedFile& target) {
+    return reinterpret_cast<IndexEntry*>(target.data() + sizeof(Header));
+}
+
+BackingStore::Record* BackingStore::getRecords(const MappedFile& target) {
+    return reinterpret_cast<Record*>(target.data() + sizeof(Header) + static_cast<size_t>(getHeader(target)->indexCapacity) * sizeof(IndexEntry));
+}
+
+void BackingStore::format(uint32_t recordCapacity) {
+    if (!formatFile(file, recordCapacity)) {
+        std::cerr << "Cannot resize backing store " << filename << std::endl;
     }
-    if (inputFile.is_open()) {
-        inputFile.close();
+}
+
+bool BackingStore::formatFile(MappedFile& target, uint32_t recordCapacity) {
+    uint32_t indexCapacity = recordCapacity * 2;
+    if (!target.resize(sizeof(Header) + static_cast<size_t>(indexCapacity) * sizeof(IndexEntry) + static_cast<size_t>(recordCapacity) * sizeof(Record))) {
+        return false;
     }
+
+    Header* header = reinterpret_cast<Header*>(target.data());
+    std::memset(header, 0, sizeof(Header));
+    header->magic = BACKING_STORE_MAGIC;
+    header->version = BACKING_STORE_VERSION;
+    header->recordSize = sizeof(Record);
+    header->recordCapacity = recordCapacity;
+    header->indexCapacity = indexCapacity;
+
+    IndexEntry* index = reinterpret_cast<IndexEntry*>(target.data() + sizeof(Header));
+    for (uint32_t i = 0; i < indexCapacity; ++i) {
+        index[i] = { EMPTY_PID, -1 };
+    }
+    return true;
 }
 
-void BackingStore::storeProcess(std::shared_ptr<Process> process) {
-    if (outputFile.is_open()) {
-        outputFile << process->getID() << " "
-            << process->getName() << " "
-            << process->getTotalInstructions() << " "
-            << process->getMemorySize() << std::endl;
-        storedProcesses[process->getID()] = process;
+bool BackingStore::grow() {
+    // Keep the records aside, the index in front of them gets bigger
+    Header header = *getHeader();
+    std::vector<Record> records(getRecords(), getRecords() + header.numRecords);
+
+    format(header.recordCapacity * 2);
+    if (!file.isOpen()) {
+        return false;
     }
+
+    std::memcpy(getRecords(), records.data(), records.size() * sizeof(Record));
+    getHeader()->numRecords = header.numRecords;
+    rebuildIndex();
+    return true;
 }
 
-std::shared_ptr<Process> BackingStore::loadProcess(int pid) {
-    auto it = storedProcesses.find(pid);
-    if (it != storedProcesses.end()) {
-        return it->second;
+void BackingStore::rebuildIndex() {
+    rebuildIndex(file);
+}
+
+void BackingStore::rebuildIndex(MappedFile& target) {
+    Header* header = getHeader(target);
+    IndexEntry* index = getIndex(target);
+    for (uint32_t i = 0; i < header->indexCapacity; ++i) {
+        index[i] = { EMPTY_PID, -1 };
     }
-    else {
-        std::shared_ptr<Process> process = std::make_shared<Process>();
-        if (inputFile.is_open()) {
-            inputFile.clear();
-            inputFile.seekg(0, std::ios::beg); // Reset to beginning
-            int id;
-            std::string name;
-            float totalInstructions, memorySize;
-            while (inputFile >> id >> name >> totalInstructions >> memorySize) {
-                if (id == pid) {
-                    process = std::make_shared<Process>(name, id, totalInstructions, memorySize, 1);
-                    storedProcesses[id] = process;
-                    return process;
-                }
-            }
+    header->numIndexTombstones = 0;
+    header->numLiveRecords = 0;
+
+    Record* records = getRecords(target);
+    for (uint32_t record = 0; record < header->numRecords; ++record) {
+        if (records[record].flags & RECORD_LIVE) {
+            insertEntry(target, records[record].pid, static_cast<int>(record));
+            ++header->numLiveRecords;
+        }
+    }
+}
+
+BackingStore::IndexEntry* BackingStore::findEntry(int pid) const {
+    if (!file.isOpen()) {
+        return nullptr;
+    }
+
+    // Linear probing, removed entries keep the probe chain going
+    uint32_t mask = getHeader()->indexCapacity - 1;
+    IndexEntry* index = getIndex();
+    for (uint32_t slot = hashPID(pid) & mask; index[slot].pid != EMPTY_PID; slot = (slot + 1) & mask) {
+        if (index[slot].pid == pid) {
+            return &index[slot];
         }
+    }
+    return nullptr;
+}
+
+void BackingStore::insertEntry(int pid, int record) {
+    insertEntry(file, pid, record);
+}
+
+void BackingStore::insertEntry(MappedFile& target, int pid, int record) {
+    Header* header = getHeader(target);
+    uint32_t mask = header->indexCapacity - 1;
+    IndexEntry* index = getIndex(target);
+
+    uint32_t slot = hashPID(pid) & mask;
+    while (index[slot].pid != EMPTY_PID && index[slot].pid != REMOVED_PID) {
+        slot = (slot + 1) & mask;
+    }
+    if (index[slot].pid == REMOVED_PID) {
+        --header->numIndexTombstones;
+    }
+    index[slot] = { pid, record };
+}
+
+void BackingStore::storeRecord(int pid, const std::string& name, int totalInstructions, float memorySize, float pageSize) {
+    if (!file.isOpen()) {
+        return;
+    }
+    if (getHeader()->numRecords == getHeader()->recordCapacity && !grow()) {
+        return;
+    }
+
+    Header* header = getHeader();
+    Record& record = getRecords()[header->numRecords];
+    std::memset(&record, 0, sizeof(Record));
+    record.pid = pid;
+    record.flags = RECORD_LIVE;
+    record.totalInstructions = totalInstructions;
+    record.memorySize = memorySize;
+    record.pageSize = pageSize;
+    size_t nameLength = name.size() < sizeof(record.name) ? name.size() : sizeof(record.name) - 1;
+    std::memcpy(record.name, name.data(), nameLength);
+
+    // A process stored again replaces its old record, which stays in the file dead
+    IndexEntry* entry = findEntry(pid);
+    if (entry) {
+        getRecords()[entry->record].flags &= ~RECORD_LIVE;
+        entry->record = static_cast<int32_t>(header->numRecords);
+    }
+    else {
+        insertEntry(pid, static_cast<int>(header->numRecords));
+        ++header->numLiveRecords;
+    }
+    ++header->numRecords;
+}
+
+void BackingStore::storeProcess(std::shared_ptr<Process> process) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    storeRecord(process->getID(), process->getName(), process->getTotalInstructions(), process->getMemorySize(), process->getPageSize());
+}
+
+std::shared_ptr<Process> BackingStore::loadProcess(int pid) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    IndexEntry* entry = findEntry(pid);
+    if (!entry) {
         throw std::runtime_error("Process not found in backing store.");
     }
+
+    const Record& record = getRecords()[entry->record];
+    return std::make_shared<Process>(std::string(record.name), record.pid, record.totalInstructions, record.memorySize, record.pageSize);
 }
 
 void BackingStore::removeProcess(int pid) {
-    storedProcesses.erase(pid);
-    // Updating the file is complex; usually not done in this simple example
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    IndexEntry* entry = findEntry(pid);
+    if (entry) {
+        removeEntry(entry);
+    }
+}
+
+void BackingStore::removeEntry(IndexEntry* entry) {
+    Header* header = getHeader();
+    getRecords()[entry->record].flags &= ~RECORD_LIVE;
+    *entry = { REMOVED_PID, -1 };
+    --header->numLiveRecords;
+    ++header->numIndexTombstones;
+
+    // Too many removed entries make every probe long
+    if (header->numLiveRecords + header->numIndexTombstones > header->indexCapacity * 3 / 4) {
+        rebuildIndex();
+    }
+}
+
+bool BackingStore::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    if (!file.isOpen()) {
+        return false;
+    }
+    uint32_t deadRecords = getHeader()->numRecords - getHeader()->numLiveRecords;
+    return deadRecords >= MIN_DEAD_RECORDS_TO_COMPACT && deadRecords > getHeader()->numLiveRecords;
+}
+
+bool BackingStore::compact() {
+    std::lock_guard<std::mutex> compactLock(compactMutex);
+    auto start = std::chrono::steady_clock::now();
+
+    // Snapshot the live records, stores and removes carry on against the old file meanwhile
+    std::vector<Record> liveRecords;
+    std::vector<uint32_t> oldPositions;
+    uint32_t snapshotRecords;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        if (!file.isOpen()) {
+            return false;
+        }
+        const Record* records = getRecords();
+        snapshotRecords = getHeader()->numRecords;
+        for (uint32_t record = 0; record < snapshotRecords; ++record) {
+            if (records[record].flags & RECORD_LIVE) {
+                liveRecords.push_back(records[record]);
+                oldPositions.push_back(record);
+            }
+        }
+    }
+    auto snapshotPause = std::chrono::steady_clock::now() - start; // stores wait for the snapshot too
+
+    // Write the new file without the lock, records and index
+    uint32_t recordCapacity = INITIAL_RECORD_CAPACITY;
+    while (recordCapacity < liveRecords.size() * 2) {
+        recordCapacity *= 2;
+    }
+    std::string segmentFilename = filename + ".compact";
+    MappedFile segment; // holds the old file after the swap, closed once the lock is released
+    if (!segment.open(segmentFilename, sizeof(Header)) || !formatFile(segment, recordCapacity)) {
+        std::cerr << "Cannot write compacted backing store " << segmentFilename << std::endl;
+        return false;
+    }
+    std::memcpy(getRecords(segment), liveRecords.data(), liveRecords.size() * sizeof(Record));
+    getHeader(segment)->numRecords = static_cast<uint32_t>(liveRecords.size());
+    rebuildIndex(segment);
+    segment.flush();
+
+    auto pauseStart = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    // Records of the snapshot that died since and records stored since, grow() keeps record positions so the old ones still hold
+    std::vector<bool> died(liveRecords.size());
+    for (size_t i = 0; i < liveRecords.size(); ++i) {
+        died[i] = !(getRecords()[oldPositions[i]].flags & RECORD_LIVE);
+    }
+    std::vector<Record> storedSince;
+    for (uint32_t record = snapshotRecords; record < getHeader()->numRecords; ++record) {
+        if (getRecords()[record].flags & RECORD_LIVE) {
+            storedSince.push_back(getRecords()[record]);
+        }
+    }
+    uint32_t oldRecords = getHeader()->numRecords;
+
+    if (!segment.replaceFile(file)) {
+        std::cerr << "Cannot replace " << filename << " with the compacted backing store" << std::endl;
+        return false;
+    }
+
+    // Replay them on the new file
+    for (size_t i = 0; i < died.size(); ++i) {
+        IndexEntry* entry = died[i] ? findEntry(liveRecords[i].pid) : nullptr;
+        if (entry && entry->record == static_cast<int32_t>(i)) {
+            removeEntry(entry);
+        }
+    }
+    for (const Record& record : storedSince) {
+        storeRecord(record.pid, record.name, record.totalInstructions, record.memorySize, record.pageSize);
+    }
+
+    ++numCompactions;
+    numRecordsReclaimed += static_cast<long long>(oldRecords) - getHeader()->numRecords;
+    auto end = std::chrono::steady_clock::now();
+    lastCompactionTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    lastCompactionPause = std::chrono::duration_cast<std::chrono::microseconds>(snapshotPause + (end - pauseStart)).count();
+    return true;
 }
 
 void BackingStore::displayContents() const {
-    if (storedProcesses.empty()) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    if (!file.isOpen() || getHeader()->numLiveRecords == 0) {
         std::cout << "Backing store is empty." << std::endl;
         return;
     }
 
     std::cout << "Backing Store Contents:" << std::endl;
-    for (const auto& entry : storedProcesses) {
-        std::shared_ptr<Process> process = entry.second;
-        std::cout << "Process ID: " << process->getID()
-            << ", Name: " << process->getName()
-            << ", Memory Size: " << process->getMemorySize()
-            << ", Instructions: " << process->getTotalInstructions() << std::endl;
+    const Record* records = getRecords();
+    for (uint32_t i = 0; i < getHeader()->numRecords; ++i) {
+        if (records[i].flags & RECORD_LIVE) {
+            std::cout << "Process ID: " << records[i].pid
+                << ", Name: " << records[i].name
+                << ", Memory Size: " << records[i].memorySize
+                << ", Instructions: " << records[i].totalInstructions << std::endl;
+        }
+    }
+}
+
+int BackingStore::importTextFile(const std::string& textFilename) {
+    std::ifstream textFile(textFilename);
+    if (!textFile.is_open()) {
+        return -1;
+    }
+
+    // A process may be listed several times, the last line wins like it did for the old loadProcess cache
+    struct TextRecord {
+        std::string name;
+        float totalInstructions;
+        float memorySize;
+    };
+    std::map<int, TextRecord> textRecords;
+    int id;
+    TextRecord textRecord;
+    while (textFile >> id >> textRecord.name >> textRecord.totalInstructions >> textRecord.memorySize) {
+        textRecords[id] = textRecord;
+    }
+
+    std::lock_guard<std::mutex> lock(storeMutex);
+    for (const auto& entry : textRecords) {
+        // the text format has no page size, the old loader used 1
+        storeRecord(entry.first, entry.second.name, static_cast<int>(entry.second.totalInstructions), entry.second.memorySize, 1);
+    }
+    file.flush();
+    return static_cast<int>(textRecords.size());
+}
+
+bool BackingStore::configureSwap(const std::string& swapFilename, int numSlots, int slotSize) {
+    if (slotSize < static_cast<int>(sizeof(SwapSlotHeader))) {
+        slotSize = sizeof(SwapSlotHeader);
+    }
+    swapSlotSize = static_cast<size_t>(slotSize);
+
+    // Slots are only meaningful to the swap map of this run
+    size_t swapFileSize = static_cast<size_t>(numSlots) * swapSlotSize;
+    if (!swapFile.open(swapFilename, swapFileSize) || !swapFile.resize(swapFileSize)) {
+        std::cerr << "Cannot map swap area " << swapFilename << std::endl;
+        swapFile.close();
+        return false;
+    }
+    return true;
+}
+
+void BackingStore::writePage(int slot, int pid, int pageNumber) {
+    writePages(slot, { { pid, pageNumber } });
+}
+
+void BackingStore::writePages(int firstSlot, const std::vector<std::pair<int, int>>& pages) {
+    if (!swapFile.isOpen() || pages.empty()) {
+        return;
+    }
+
+    size_t offset = static_cast<size_t>(firstSlot) * swapSlotSize;
+    char* slotData = swapFile.data() + offset;
+    for (const auto& page : pages) {
+        fillPage(slotData, swapSlotSize, page.first, page.second);
+        slotData += swapSlotSize;
+    }
+    swapFile.flush(offset, pages.size() * swapSlotSize);
+
+    numPageWrites += static_cast<long long>(pages.size());
+    ++numPageWriteRuns;
+}
+
+bool BackingStore::readPage(int slot, int pageNumber) {
+    if (!swapFile.isOpen()) {
+        return false;
     }
+
+    ++numPageReads;
+    if (!isPage(swapFile.data() + static_cast<size_t>(slot) * swapSlotSize, pageNumber)) {
+        ++numPageReadErrors;
+        return false;
+    }
+    return true;
+}
+
+void BackingStore::fillPage(char* data, size_t size, int pid, int pageNumber) {
+    SwapSlotHeader header = { pid, pageNumber };
+    std::memcpy(data, &header, sizeof(header));
+
+    // Processes have no real memory contents, each page gets a mix of repeated and random 32-byte blocks like real data would
+    // One page in four is all zeros, the others have three in four, one in two or none of their blocks repeated
+    uint32_t seed = hashPID(pid) ^ (static_cast<uint32_t>(pageNumber) * 40503u) ^ 0x9E3779B9u;
+    auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    };
+    const uint32_t repeatedBlocks[] = { 8, 6, 4, 0 }; // out of 8
+    uint32_t repeated = repeatedBlocks[random() % 4];
+
+    const size_t BLOCK_SIZE = 32;
+    for (size_t offset = sizeof(header); offset < size; offset += BLOCK_SIZE) {
+        size_t length = std::min(BLOCK_SIZE, size - offset);
+        if (repeated == 8) {
+            std::memset(data + offset, 0, length);
+        }
+        else if (random() % 8 < repeated) {
+            std::memset(data + offset, static_cast<int>(random() & 0xFF), length);
+        }
+        else {
+            for (size_t i = 0; i < length; ++i) {
+                data[offset + i] = static_cast<char>(random() & 0xFF);
+            }
+        }
+    }
+}
+
+bool BackingStore::isPage(const char* data, int pageNumber) {
+    SwapSlotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    return header.pageNumber == pageNumber;
+}
+
+int BackingStore::getNumRecords() const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return file.isOpen() ? static_cast<int>(getHeader()->numRecords) : 0;
+}
+
+int BackingStore::getNumLiveRecords() const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return file.isOpen() ? static_cast<int>(getHeader()->numLiveRecords) : 0;
+}
+
+size_t BackingStore::getFileSize() const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return file.size();
+}
+
+long long BackingStore::getNumPageWrites() const {
+    return numPageWrites;
+}
+
+long long BackingStore::getNumPageWriteRuns() const {
+    return numPageWriteRuns;
+}
+
+long long BackingStore::getNumPageReads() const {
+    return numPageReads;
+}
+
+long long BackingStore::getNumPageReadErrors() const {
+    return numPageReadErrors;
+}
+
+double BackingStore::getSpaceAmplification() const {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!file.isOpen() || getHeader()->numLiveRecords == 0) {
+        return file.isOpen() && getHeader()->numRecords > 0 ? getHeader()->numRecords : 1;
+    }
+    return static_cast<double>(getHeader()->numRecords) / getHeader()->numLiveRecords;
+}
+
+long long BackingStore::getNumCompactions() const {
+    return numCompactions;
+}
+
+long long BackingStore::getNumRecordsReclaimed() const {
+    return numRecordsReclaimed;
+}
+
+long long BackingStore::getLastCompactionTime() const {
+    return lastCompactionTime;
+}
+
+long long BackingStore::getLastCompactionPause() const {
+    return lastCompactionPause;
 }
@@ -1,10 +1,19 @@
 #pragma once
-#include <unordered_map>
 #include <memory>
 #include <string>
-#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <utility>
 #include "Process.h"
+#include "MappedFile.h"
 
+// Swapped out processes in a memory-mapped binary file
+// Layout: header, open-addressing index of pid -> record, then fixed-size records in the order they were stored
+// Storing a process again or removing it only marks its old record dead, so stores are appends and loads one index probe
+// Compaction copies the live records into a new file in the background and renames it over the old one
+// Paged out pages go to a second file of page-sized slots, the paging allocator decides which slot holds which page
 class BackingStore {
 public:
     BackingStore(const std::string& filename);
@@ -15,12 +24,98 @@ public:
     void removeProcess(int pid);
     void displayContents() const;
 
+    int importTextFile(const std::string& textFilename); // migrate the old "id name instructions memsize" text format, returns the processes imported or -1
+
+    // Swap area
+    bool configureSwap(const std::string& swapFilename, int numSlots, int slotSize); // slotSize in bytes, the old contents are dropped
+    void writePage(int slot, int pid, int pageNumber);
+    void writePages(int firstSlot, const std::vector<std::pair<int, int>>& pages); // (pid, page number) for consecutive slots, written back as one range
+    bool readPage(int slot, int pageNumber); // false if the slot does not hold the page, a shared slot holds it for every clone
+    static void fillPage(char* data, size_t size, int pid, int pageNumber); // contents of a page, processes have no real memory so they are derived from the page
+    static bool isPage(const char* data, int pageNumber); // the contents start with the page's header
+
+    // Compaction
+    bool needsCompaction() const; // dead records outnumber the live ones
+    bool compact(); // stores and loads only wait while the new file is swapped in, false if it could not be written
+
+    // Stats
+    int getNumRecords() const; // live and dead records in the file
+    int getNumLiveRecords() const;
+    size_t getFileSize() const;
+    long long getNumPageWrites() const;
+    long long getNumPageWriteRuns() const; // ranges written back, a run of adjacent slots counts once
+    long long getNumPageReads() const;
+    long long getNumPageReadErrors() const; // reads of a slot holding another page
+    double getSpaceAmplification() const; // records in the file per live record (or per one record if none is live), 1 right after a compaction
+    long long getNumCompactions() const;
+    long long getNumRecordsReclaimed() const; // dead records dropped by compaction
+    long long getLastCompactionTime() const; // microseconds, copy and swap
+    long long getLastCompactionPause() const; // microseconds stores and loads waited for the swap
+
 private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t recordCapacity;
+        uint32_t indexCapacity; // power of two, twice the record capacity
+        uint32_t numRecords;
+        uint32_t numLiveRecords;
+        uint32_t numIndexTombstones;
+        uint32_t reserved[8];
+    };
+
+    struct IndexEntry {
+        int32_t pid; // EMPTY_PID or REMOVED_PID if the slot holds no process
+        int32_t record;
+    };
+
+    struct Record {
+        int32_t pid;
+        uint32_t flags; // RECORD_LIVE until the process is stored again or removed
+        int32_t totalInstructions;
+        float memorySize;
+        float pageSize;
+        char name[44]; // truncated, always null-terminated
+    };
+
     std::string filename;
-    std::unordered_map<int, std::shared_ptr<Process>> storedProcesses;
-    std::ofstream outputFile;
-    std::ifstream inputFile;
+    MappedFile file;
+    mutable std::mutex storeMutex; // evictions come from the cores and the memory thread
+    std::mutex compactMutex; // one compaction at a time
+    std::atomic<long long> numCompactions;
+    std::atomic<long long> numRecordsReclaimed;
+    std::atomic<long long> lastCompactionTime;
+    std::atomic<long long> lastCompactionPause;
+
+    // Each slot starts with a SwapSlotHeader, the paging allocator never hands the same slot to two writers
+    struct SwapSlotHeader {
+        int32_t pid; // process that wrote the page
+        int32_t pageNumber;
+    };
+
+    MappedFile swapFile;
+    size_t swapSlotSize;
+    std::atomic<long long> numPageWrites;
+    std::atomic<long long> numPageWriteRuns;
+    std::atomic<long long> numPageReads;
+    std::atomic<long long> numPageReadErrors;
+
+    Header* getHeader() const;
+    IndexEntry* getIndex() const;
+    Record* getRecords() const;
+    static Header* getHeader(const MappedFile& target);
+    static IndexEntry* getIndex(const MappedFile& target);
+    static Record* getRecords(const MappedFile& target);
 
-    void openFiles();
-    void closeFiles();
+    void format(uint32_t recordCapacity); // start an empty store
+    static bool formatFile(MappedFile& target, uint32_t recordCapacity); // empty store layout in any file
+    bool grow(); // double the capacity, records keep their order
+    void rebuildIndex(); // reinsert the live records, drops the tombstones
+    static void rebuildIndex(MappedFile& target);
+    IndexEntry* findEntry(int pid) const; // nullptr if the process is not stored
+    void insertEntry(int pid, int record);
+    static void insertEntry(MappedFile& target, int pid, int record);
+    void removeEntry(IndexEntry* entry); // the record goes dead and the entry becomes a tombstone
+    void storeRecord(int pid, const std::string& name, int totalInstructions, float memorySize, float pageSize);
 };
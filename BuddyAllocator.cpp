@@ -0,0 +1,163 @@
+#include "BuddyAllocator.h"
+#include <iostream>
+#include <cmath>
+
+BuddyAllocator::BuddyAllocator()
+    : configManager(nullptr), memorySize(0), minOrder(0), maxOrder(0), usedMemory(0), requestedMemory(0) {}
+
+void BuddyAllocator::initialize(ConfigurationManager* newConfigManager) {
+    configManager = newConfigManager;
+    memorySize = static_cast<int>(configManager->getMaxOverallMemory());
+
+    // Process sizes are powers of two from min-mem-per-proc, so smaller blocks are never needed
+    int minSize = std::max(1, static_cast<int>(configManager->getMinMemoryPerProcess()));
+    minOrder = static_cast<int>(std::ceil(std::log2(minSize)));
+    maxOrder = static_cast<int>(std::floor(std::log2(std::max(1, memorySize))));
+    if (minOrder > maxOrder) {
+        minOrder = maxOrder;
+    }
+
+    freeLists.assign(maxOrder + 1, std::set<int>());
+    freeBitmaps.assign(maxOrder + 1, std::vector<uint64_t>());
+    for (int order = minOrder; order <= maxOrder; ++order) {
+        size_t numBlocks = static_cast<size_t>(memorySize) >> order;
+        freeBitmaps[order].assign((numBlocks + 63) / 64, 0);
+    }
+    processBlocks.clear();
+    usedMemory = 0;
+    requestedMemory = 0;
+
+    // Memory that is not a power of two is split into the largest aligned blocks that fit
+    int start = 0;
+    for (int order = maxOrder; order >= minOrder; --order) {
+        while (start + (1 << order) <= memorySize && start % (1 << order) == 0) {
+            addFreeBlock(start, order);
+            start += 1 << order;
+        }
+    }
+}
+
+int BuddyAllocator::getOrder(int size) const {
+    int order = minOrder;
+    while (order <= maxOrder && (1 << order) < size) {
+        ++order;
+    }
+    return order;
+}
+
+void BuddyAllocator::addFreeBlock(int start, int order) {
+    size_t index = static_cast<size_t>(start) >> order;
+    freeLists[order].insert(start);
+    freeBitmaps[order][index / 64] |= (uint64_t(1) << (index % 64));
+}
+
+void BuddyAllocator::removeFreeBlock(int start, int order) {
+    size_t index = static_cast<size_t>(start) >> order;
+    freeLists[order].erase(start);
+    freeBitmaps[order][index / 64] &= ~(uint64_t(1) << (index % 64));
+}
+
+bool BuddyAllocator::isFreeBlock(int start, int order) const {
+    size_t index = static_cast<size_t>(start) >> order;
+    if (index / 64 >= freeBitmaps[order].size()) {
+        return false; // buddy lies outside of memory
+    }
+    return (freeBitmaps[order][index / 64] >> (index % 64)) & 1;
+}
+
+bool BuddyAllocator::allocate(Process process) {
+    int processSize = static_cast<int>(process.getMemorySize());
+    int order = getOrder(processSize);
+    if (order > maxOrder) {
+        return false; // process is bigger than memory
+    }
+
+    // find the smallest order with a free block
+    int currentOrder = order;
+    while (currentOrder <= maxOrder && freeLists[currentOrder].empty()) {
+        ++currentOrder;
+    }
+    if (currentOrder > maxOrder) {
+        return false; // no sufficient free block found
+    }
+
+    int start = *freeLists[currentOrder].begin();
+    removeFreeBlock(start, currentOrder);
+
+    // split the block until it has the right size, freeing the upper halves
+    while (currentOrder > order) {
+        --currentOrder;
+        addFreeBlock(start + (1 << currentOrder), currentOrder);
+    }
+
+    processBlocks[process.getID()] = { start, order, processSize };
+    usedMemory += 1 << order;
+    requestedMemory += processSize;
+    return true;
+}
+
+void BuddyAllocator::deallocate(int pid) {
+    auto it = processBlocks.find(pid);
+    if (it == processBlocks.end()) {
+        return;
+    }
+
+    int start = it->second.start;
+    int order = it->second.order;
+    usedMemory -= 1 << order;
+    requestedMemory -= it->second.requestedSize;
+    processBlocks.erase(it);
+
+    // merge with the buddy for as long as the buddy is free
+    while (order < maxOrder) {
+        int buddy = start ^ (1 << order);
+        if (!isFreeBlock(buddy, order)) {
+            break;
+        }
+        removeFreeBlock(buddy, order);
+        start = std::min(start, buddy);
+        ++order;
+    }
+    addFreeBlock(start, order);
+}
+
+int BuddyAllocator::swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs) {
+    std::vector<int> nonRunningProcesses;
+    for (const auto& entry : processBlocks) {
+        if (runningProcessIDs.find(entry.first) == runningProcessIDs.end()) {
+            nonRunningProcesses.push_back(entry.first);
+        }
+    }
+
+    if (nonRunningProcesses.empty()) {
+        return -1;
+    }
+
+    int pid = nonRunningProcesses[rand() % nonRunningProcesses.size()];
+    deallocate(pid);
+    return pid;
+}
+
+int BuddyAllocator::getUsedMemory() const {
+    return usedMemory;
+}
+
+int BuddyAllocator::getFreeMemory() const {
+    return memorySize - usedMemory;
+}
+
+int BuddyAllocator::getLargestFreeBlock() const {
+    for (int order = maxOrder; order >= minOrder; --order) {
+        if (!freeLists[order].empty()) {
+            return 1 << order;
+        }
+    }
+    return 0;
+}
+
+float BuddyAllocator::getInternalFragmentation() const {
+    if (usedMemory == 0) {
+        return 0;
+    }
+    return (1.0f - static_cast<float>(requestedMemory) / usedMemory) * 100;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+
+#include "Process.h"
+#include "ConfigurationManager.h"
+
+// BuddyBlock struct (for buddy alloc)
+struct BuddyBlock {
+	int start;	// start address of the block
+	int order;	// block size is 2^order
+	int requestedSize;	// memory the process actually asked for
+};
+
+class BuddyAllocator
+{
+public:
+	BuddyAllocator();
+
+	void initialize(ConfigurationManager* configManager); // build the free lists from the overall memory
+	bool allocate(Process process);	// allocate a 2^n block for a process
+	void deallocate(int pid);
+	int swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs); // swap out a random process
+
+	int getUsedMemory() const; // memory in allocated blocks (active + idle processes), safe to call without the allocator lock
+	int getFreeMemory() const; // safe to call without the allocator lock
+	int getLargestFreeBlock() const; // needs the allocator lock
+	float getInternalFragmentation() const; // percentage of allocated memory that processes did not ask for, needs the allocator lock
+
+private:
+	ConfigurationManager* configManager;
+	int memorySize;	// total memory size
+	int minOrder;	// smallest block is 2^minOrder
+	int maxOrder;	// largest block is 2^maxOrder
+
+	std::vector<std::set<int>> freeLists; // free block start addresses per order, lowest address first
+	std::vector<std::vector<uint64_t>> freeBitmaps; // bit i of order k is set if block i (start = i << k) is free
+	std::unordered_map<int, BuddyBlock> processBlocks; // pid -> allocated block
+
+	std::atomic<int> usedMemory;	// sum of allocated block sizes
+	int requestedMemory;	// sum of requested sizes of allocated blocks
+
+	int getOrder(int size) const; // smallest order whose block fits size
+	void addFreeBlock(int start, int order);
+	void removeFreeBlock(int start, int order);
+	bool isFreeBlock(int start, int order) const;
+};
@@ -0,0 +1,188 @@
+#include "CompressedSwapPool.h"
+#include <cstring>
+
+CompressedSwapPool::CompressedSwapPool(SwapIOEngine& swapIO)
+    : swapIO(swapIO), capacity(0), pageBytes(0), compressedSize(0), numStores(0), numRejected(0), numWritebacks(0),
+      numPoolHits(0), numFileReads(0), numInvalidated(0) {}
+
+void CompressedSwapPool::initialize(size_t capacity, int pageBytes) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    this->capacity = capacity;
+    this->pageBytes = pageBytes;
+    entries.clear();
+    lru.clear();
+    compressedSize = 0;
+    pageBuffer.assign(capacity > 0 ? pageBytes : 0, 0);
+}
+
+void CompressedSwapPool::storePage(int slot, int pid, int pageNumber) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    if (capacity == 0) {
+        swapIO.submitWrite(slot, pid, pageNumber);
+        return;
+    }
+
+    // A freed slot is invalidated, but a slot handed out again must never answer with its old page
+    auto old = entries.find(slot);
+    if (old != entries.end()) {
+        removeEntry(old);
+    }
+
+    ++numStores;
+    BackingStore::fillPage(pageBuffer.data(), pageBuffer.size(), pid, pageNumber);
+    std::vector<char> compressed;
+    compress(pageBuffer.data(), pageBuffer.size(), compressed);
+    if (compressed.size() >= pageBuffer.size() || compressed.size() > capacity) {
+        ++numRejected;
+        swapIO.submitWrite(slot, pid, pageNumber);
+        return;
+    }
+
+    // Make room by writing the coldest pages back to the file; the writes are queued under the pool lock so a fault
+    // that misses the pool finds them in the swap I/O queue
+    while (compressedSize + compressed.size() > capacity) {
+        auto cold = entries.find(lru.back());
+        swapIO.submitWrite(cold->first, cold->second.pid, cold->second.pageNumber);
+        removeEntry(cold);
+        ++numWritebacks;
+    }
+
+    lru.push_front(slot);
+    compressedSize += compressed.size();
+    Entry& entry = entries[slot];
+    entry.pid = pid;
+    entry.pageNumber = pageNumber;
+    entry.compressed.swap(compressed);
+    entry.lruPosition = lru.begin();
+}
+
+bool CompressedSwapPool::loadPage(int slot, int pageNumber) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+
+        auto entry = entries.find(slot);
+        if (entry != entries.end()) {
+            // the page stays in the pool while clones still refer to the slot, the last one frees it
+            ++numPoolHits;
+            lru.splice(lru.begin(), lru, entry->second.lruPosition);
+            return decompress(entry->second.compressed, pageBuffer.data(), pageBuffer.size())
+                && BackingStore::isPage(pageBuffer.data(), pageNumber);
+        }
+    }
+
+    ++numFileReads;
+    return swapIO.readPage(slot, pageNumber);
+}
+
+void CompressedSwapPool::invalidate(int slot) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    auto entry = entries.find(slot);
+    if (entry != entries.end()) {
+        removeEntry(entry);
+        ++numInvalidated;
+    }
+}
+
+void CompressedSwapPool::removeEntry(std::unordered_map<int, Entry>::iterator entry) {
+    compressedSize -= entry->second.compressed.size();
+    lru.erase(entry->second.lruPosition);
+    entries.erase(entry);
+}
+
+void CompressedSwapPool::compress(const char* data, size_t size, std::vector<char>& compressed) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < 130 && bytes[i + run] == bytes[i]) {
+            ++run;
+        }
+        if (run >= 3) {
+            compressed.push_back(static_cast<char>(run + 125));
+            compressed.push_back(static_cast<char>(bytes[i]));
+            i += run;
+            continue;
+        }
+
+        // literals up to the next run of three
+        size_t start = i;
+        while (i < size && i - start < 128 && !(i + 2 < size && bytes[i] == bytes[i + 1] && bytes[i] == bytes[i + 2])) {
+            ++i;
+        }
+        compressed.push_back(static_cast<char>(i - start - 1));
+        compressed.insert(compressed.end(), data + start, data + i);
+    }
+}
+
+bool CompressedSwapPool::decompress(const std::vector<char>& compressed, char* data, size_t size) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < compressed.size()) {
+        size_t control = static_cast<unsigned char>(compressed[in++]);
+        if (control >= 128) {
+            size_t run = control - 125;
+            if (in >= compressed.size() || out + run > size) {
+                return false;
+            }
+            std::memset(data + out, compressed[in++], run);
+            out += run;
+        }
+        else {
+            size_t length = control + 1;
+            if (in + length > compressed.size() || out + length > size) {
+                return false;
+            }
+            std::memcpy(data + out, compressed.data() + in, length);
+            in += length;
+            out += length;
+        }
+    }
+    return out == size;
+}
+
+size_t CompressedSwapPool::getCapacity() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return capacity;
+}
+
+size_t CompressedSwapPool::getCompressedSize() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return compressedSize;
+}
+
+int CompressedSwapPool::getNumPages() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return static_cast<int>(entries.size());
+}
+
+double CompressedSwapPool::getCompressionRatio() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return compressedSize > 0 ? static_cast<double>(entries.size()) * pageBytes / compressedSize : 0;
+}
+
+long long CompressedSwapPool::getNumStores() const {
+    return numStores;
+}
+
+long long CompressedSwapPool::getNumRejected() const {
+    return numRejected;
+}
+
+long long CompressedSwapPool::getNumWritebacks() const {
+    return numWritebacks;
+}
+
+long long CompressedSwapPool::getNumPoolHits() const {
+    return numPoolHits;
+}
+
+long long CompressedSwapPool::getNumFileReads() const {
+    return numFileReads;
+}
+
+long long CompressedSwapPool::getNumInvalidated() const {
+    return numInvalidated;
+}
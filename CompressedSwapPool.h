@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "SwapIOEngine.h"
+
+// zswap-like compressed RAM tier between page eviction and the swap file
+// Evicted pages are compressed into a pool capped at a share of memory, the least recently used ones are written
+// back to their slot in the file when it fills up. Faults read the pool first and only go to the file on a miss.
+// Pages that do not compress below a page go straight to the file. With no capacity every page goes to the file.
+class CompressedSwapPool
+{
+public:
+    CompressedSwapPool(SwapIOEngine& swapIO);
+
+    void initialize(size_t capacity, int pageBytes); // capacity in bytes of compressed data, 0 disables the pool
+
+    // Swap callbacks of the paging allocator
+    void storePage(int slot, int pid, int pageNumber); // evicted page, compressed into the pool or written to the file
+    bool loadPage(int slot, int pageNumber); // false if the slot held another page
+    void invalidate(int slot); // the slot was freed, its page is dropped from the pool
+
+    // Stats
+    size_t getCapacity() const;
+    size_t getCompressedSize() const; // bytes in the pool
+    int getNumPages() const; // pages in the pool
+    double getCompressionRatio() const; // uncompressed size over compressed size of the pages in the pool
+    long long getNumStores() const; // evicted pages that came through the pool
+    long long getNumRejected() const; // pages that did not compress and went to the file
+    long long getNumWritebacks() const; // cold pages pushed out of the pool to the file
+    long long getNumPoolHits() const; // faults answered from the pool
+    long long getNumFileReads() const; // faults that had to read the file
+    long long getNumInvalidated() const; // pages freed while in the pool, never written to the file
+
+    // PackBits run-length coding, a control byte below 128 is followed by that many plus one literal bytes,
+    // one of 128 or more by a byte repeated that many minus 125 times
+    static void compress(const char* data, size_t size, std::vector<char>& compressed);
+    static bool decompress(const std::vector<char>& compressed, char* data, size_t size); // false if the data does not decode to size bytes
+
+private:
+    struct Entry {
+        int pid;
+        int pageNumber;
+        std::vector<char> compressed;
+        std::list<int>::iterator lruPosition;
+    };
+
+    SwapIOEngine& swapIO;
+    size_t capacity;
+    int pageBytes;
+
+    mutable std::mutex poolMutex;
+    std::unordered_map<int, Entry> entries; // slot -> compressed page
+    std::list<int> lru; // slots, most recently stored or loaded first
+    size_t compressedSize;
+    std::vector<char> pageBuffer; // scratch page for compressing and decompressing, under poolMutex
+
+    std::atomic<long long> numStores;
+    std::atomic<long long> numRejected;
+    std::atomic<long long> numWritebacks;
+    std::atomic<long long> numPoolHits;
+    std::atomic<long long> numFileReads;
+    std::atomic<long long> numInvalidated;
+
+    void removeEntry(std::unordered_map<int, Entry>::iterator entry); // under poolMutex
+};
@@ -9,7 +9,12 @@
 ConfigurationManager::ConfigurationManager()
 	: numCPU(0), quantumCycles(0), batchProcessFrequency(0), minInstructions(0), maxInstructions(0),
 	  delayPerExec(0), maxOverallMemory(0), memoryPerFrame(0), minMemoryPerProcess(0), maxMemoryPerProcess(0),
-	  memoryManagerAlgorithm("")
+	  memoryManagerAlgorithm(""), flatFitPolicy("first"), memoryShards(1), pageReplacementPolicy("clock"), pageFaultDelay(10), pageTableType("linear"),
+	  workingSetWindow(256), thrashFaultRate(10), reclaimLowWatermark(5), reclaimHighWatermark(10),
+	  tlbEntries(0), tlbWays(4), tlbASIDTagged(true),
+	  hugePageSize(0), numaNodes(1), numaPlacement("first-touch"), numaRemoteDelay(2), numaMigrateAfter(4),
+	  swapSize(0), swapIOThreads(2), swapReadahead(8), zswapPoolPercent(20),
+	  admissionOrder("fifo"), admissionQueueDepth(64)
 {
 }
 
@@ -86,6 +91,147 @@ std::string ConfigurationManager::getMemoryManagerAlgorithm() const {
 	return memoryManagerAlgorithm;
 }
 
+std::string ConfigurationManager::getFlatFitPolicy() const {
+	return flatFitPolicy;
+}
+
+int ConfigurationManager::getMemoryShards() const {
+	return memoryShards;
+}
+
+int ConfigurationManager::getPageFaultDelay() const {
+	return pageFaultDelay;
+}
+
+std::string ConfigurationManager::getPageReplacementPolicy() const {
+	return pageReplacementPolicy;
+}
+
+std::string ConfigurationManager::getPageTableType() const {
+	return pageTableType;
+}
+
+int ConfigurationManager::getWorkingSetWindow() const {
+	return workingSetWindow;
+}
+
+float ConfigurationManager::getThrashFaultRate() const {
+	return thrashFaultRate;
+}
+
+float ConfigurationManager::getReclaimLowWatermark() const {
+	return reclaimLowWatermark;
+}
+
+float ConfigurationManager::getReclaimHighWatermark() const {
+	return reclaimHighWatermark;
+}
+
+int ConfigurationManager::getTLBEntries() const {
+	return tlbEntries;
+}
+
+int ConfigurationManager::getTLBWays() const {
+	return tlbWays;
+}
+
+bool ConfigurationManager::isTLBASIDTagged() const {
+	return tlbASIDTagged;
+}
+
+float ConfigurationManager::getHugePageSize() const {
+	return hugePageSize;
+}
+
+int ConfigurationManager::getNUMANodes() const {
+	return numaNodes;
+}
+
+std::string ConfigurationManager::getNUMAPlacement() const {
+	return numaPlacement;
+}
+
+int ConfigurationManager::getNUMARemoteDelay() const {
+	return numaRemoteDelay;
+}
+
+int ConfigurationManager::getNUMAMigrateAfter() const {
+	return numaMigrateAfter;
+}
+
+float ConfigurationManager::getSwapSize() const {
+	return swapSize;
+}
+
+int ConfigurationManager::getSwapIOThreads() const {
+	return swapIOThreads;
+}
+
+int ConfigurationManager::getSwapReadahead() const {
+	return swapReadahead;
+}
+
+float ConfigurationManager::getZswapPoolPercent() const {
+	return zswapPoolPercent;
+}
+
+std::string ConfigurationManager::getAdmissionOrder() const {
+	return admissionOrder;
+}
+
+int ConfigurationManager::getAdmissionQueueDepth() const {
+	return admissionQueueDepth;
+}
+
+void ConfigurationManager::setFlatFitPolicy(const std::string& policy) {
+	flatFitPolicy = policy;
+}
+
+void ConfigurationManager::setMemoryShards(int shards) {
+	memoryShards = shards;
+}
+
+void ConfigurationManager::setMaxOverallMemory(float memory) {
+	maxOverallMemory = memory;
+}
+
+void ConfigurationManager::setMemoryPerFrame(float memory) {
+	memoryPerFrame = memory;
+}
+
+void ConfigurationManager::setPageTableType(const std::string& type) {
+	pageTableType = type;
+}
+
+void ConfigurationManager::setHugePageSize(float size) {
+	hugePageSize = size;
+}
+
+void ConfigurationManager::setSwapSize(float size) {
+	swapSize = size;
+}
+
+void ConfigurationManager::setSwapIOThreads(int threads) {
+	swapIOThreads = threads;
+}
+
+void ConfigurationManager::setSwapReadahead(int pages) {
+	swapReadahead = pages;
+}
+
+void ConfigurationManager::setZswapPoolPercent(float percent) {
+	zswapPoolPercent = percent;
+}
+
+std::string ConfigurationManager::stripQuotes(const std::string& value) {
+	size_t first = value.find_first_not_of('\"');
+	size_t last = value.find_last_not_of('\"');
+	if (first == std::string::npos) {
+		return "";
+	}
+	return value.substr(first, last - first + 1);
+}
+
 void ConfigurationManager::parseConfigFile() {
 	std::ifstream configFile("config.txt");
 
@@ -137,12 +283,93 @@ void ConfigurationManager::parseConfigFile() {
 		} else if (key == "max-mem-per-proc") {
 			iss >> maxMemoryPerProcess;
 
+		} else if (key == "memory-manager") {
+			iss >> memoryManagerAlgorithm;
+			memoryManagerAlgorithm = stripQuotes(memoryManagerAlgorithm);
+
+		} else if (key == "flat-fit-policy") {
+			iss >> flatFitPolicy;
+			flatFitPolicy = stripQuotes(flatFitPolicy);
+
+		} else if (key == "memory-shards") {
+			iss >> memoryShards;
+
+		} else if (key == "page-replacement") {
+			iss >> pageReplacementPolicy;
+			pageReplacementPolicy = stripQuotes(pageReplacementPolicy);
+
+		} else if (key == "page-fault-delay") {
+			iss >> pageFaultDelay;
+
+		} else if (key == "page-table") {
+			iss >> pageTableType;
+			pageTableType = stripQuotes(pageTableType);
+
+		} else if (key == "working-set-window") {
+			iss >> workingSetWindow;
+
+		} else if (key == "thrash-fault-rate") {
+			iss >> thrashFaultRate;
+
+		} else if (key == "reclaim-low-watermark") {
+			iss >> reclaimLowWatermark;
+
+		} else if (key == "reclaim-high-watermark") {
+			iss >> reclaimHighWatermark;
+
+		} else if (key == "tlb-entries") {
+			iss >> tlbEntries;
+
+		} else if (key == "tlb-ways") {
+			iss >> tlbWays;
+
+		} else if (key == "tlb-asid") {
+			iss >> tlbASIDTagged; // 0 flushes the TLB on every context switch
+
+		} else if (key == "huge-page-size") {
+			iss >> hugePageSize;
+
+		} else if (key == "numa-nodes") {
+			iss >> numaNodes;
+
+		} else if (key == "numa-placement") {
+			iss >> numaPlacement;
+			numaPlacement = stripQuotes(numaPlacement);
+
+		} else if (key == "numa-remote-delay") {
+			iss >> numaRemoteDelay;
+
+		} else if (key == "numa-migrate-after") {
+			iss >> numaMigrateAfter;
+
+		} else if (key == "swap-size") {
+			iss >> swapSize;
+
+		} else if (key == "swap-io-threads") {
+			iss >> swapIOThreads;
+
+		} else if (key == "swap-readahead") {
+			iss >> swapReadahead;
+
+		} else if (key == "zswap-pool-percent") {
+			iss >> zswapPoolPercent;
+
+		} else if (key == "admission-order") {
+			iss >> admissionOrder;
+			admissionOrder = stripQuotes(admissionOrder);
+
+		} else if (key == "admission-queue-depth") {
+			iss >> admissionQueueDepth;
 		}
 	}
 
 	configFile.close();
 
-	// Determine memory manager algorithm
+	// Determine memory manager algorithm, unless it was set explicitly
+	if (!memoryManagerAlgorithm.empty()) {
+		return;
+	}
+
 	if (maxOverallMemory == memoryPerFrame) {
 		memoryManagerAlgorithm = "flat";
 
@@ -165,6 +392,37 @@ void ConfigurationManager::printConfig() {
 	std::cout << "mem-per-frame: " << memoryPerFrame << std::endl;
 	std::cout << "min-mem-per-proc: " << minMemoryPerProcess << std::endl;
 	std::cout << "max-mem-per-proc: " << maxMemoryPerProcess << std::endl;
-	std::cout << "memory-manager: " << memoryManagerAlgorithm << std::endl; // "flat" or "paging"
+	std::cout << "memory-manager: " << memoryManagerAlgorithm << std::endl; // "flat", "paging" or "buddy"
+	if (memoryManagerAlgorithm == "flat") {
+		std::cout << "flat-fit-policy: " << flatFitPolicy << std::endl; // "first", "best" or "next"
+		std::cout << "memory-shards: " << memoryShards << std::endl;
+	}
+	else if (memoryManagerAlgorithm == "paging") {
+		std::cout << "page-replacement: " << pageReplacementPolicy << std::endl; // "random", "fifo", "lru" or "clock"
+		std::cout << "page-fault-delay: " << pageFaultDelay << std::endl;
+		std::cout << "page-table: " << pageTableType << std::endl; // "linear", "radix2", "radix3" or "inverted"
+		std::cout << "working-set-window: " << workingSetWindow << std::endl;
+		std::cout << "thrash-fault-rate: " << thrashFaultRate << std::endl;
+		std::cout << "reclaim-low-watermark: " << reclaimLowWatermark << std::endl;
+		std::cout << "reclaim-high-watermark: " << reclaimHighWatermark << std::endl;
+		std::cout << "tlb-entries: " << tlbEntries << std::endl;
+		if (tlbEntries > 0) {
+			std::cout << "tlb-ways: " << tlbWays << std::endl;
+			std::cout << "tlb-asid: " << tlbASIDTagged << std::endl;
+		}
+		std::cout << "huge-page-size: " << hugePageSize << std::endl;
+		std::cout << "swap-size: " << swapSize << std::endl;
+		std::cout << "swap-readahead: " << swapReadahead << std::endl;
+		std::cout << "zswap-pool-percent: " << zswapPoolPercent << std::endl;
+		std::cout << "numa-nodes: " << numaNodes << std::endl;
+		if (numaNodes > 1) {
+			std::cout << "numa-placement: " << numaPlacement << std::endl; // "first-touch" or "interleave"
+			std::cout << "numa-remote-delay: " << numaRemoteDelay << std::endl;
+			std::cout << "numa-migrate-after: " << numaMigrateAfter << std::endl;
+		}
+	}
+	std::cout << "swap-io-threads: " << swapIOThreads << std::endl;
+	std::cout << "admission-order: " << admissionOrder << std::endl; // "fifo" or "smallest"
+	std::cout << "admission-queue-depth: " << admissionQueueDepth << std::endl;
 	std::cout << "--------------------------" << std::endl;
 }
@@ -23,11 +23,45 @@ public:
 	float getMemoryPerFrame() const; // Returns the size of memory of frames
 	float getMinMemoryPerProcess() const; // Returns the minimum memory per process
 	float getMaxMemoryPerProcess() const; // Returns the maximum memory per process
-	std::string getMemoryManagerAlgorithm() const; // Returns the memory manager algorithm
+	std::string getMemoryManagerAlgorithm() const; // Returns the memory manager algorithm ("flat", "paging" or "buddy")
+	std::string getFlatFitPolicy() const; // Returns the flat allocator fit policy ("first", "best" or "next")
+	int getMemoryShards() const; // Returns the number of arenas the flat memory is split into
+	int getPageFaultDelay() const; // Returns the cycles a process is blocked for on a major page fault
+	std::string getPageReplacementPolicy() const; // Returns the paging replacement policy ("random", "fifo", "lru" or "clock")
+	std::string getPageTableType() const; // Returns the page table layout ("linear", "radix2", "radix3" or "inverted")
+	int getWorkingSetWindow() const; // Returns the page references a working set looks back over
+	float getThrashFaultRate() const; // Returns the major fault rate (percent of references) that counts as thrashing
+	float getReclaimLowWatermark() const; // Returns the free frames (percent) below which background reclaim starts
+	float getReclaimHighWatermark() const; // Returns the free frames (percent) background reclaim stops at
+	int getTLBEntries() const; // Returns the number of TLB entries per core, 0 disables the TLB
+	int getTLBWays() const; // Returns the TLB associativity
+	bool isTLBASIDTagged() const; // Returns true if TLB entries survive context switches (tagged with the pid)
+	float getHugePageSize() const; // Returns the size of a huge page, 0 disables huge pages
+	int getNUMANodes() const; // Returns the number of NUMA nodes memory and cores are split into
+	std::string getNUMAPlacement() const; // Returns where new pages go ("first-touch" or "interleave")
+	int getNUMARemoteDelay() const; // Returns the extra cycles of an access to another node's memory
+	int getNUMAMigrateAfter() const; // Returns the remote accesses from one node after which a page migrates there, 0 disables migration
+	float getSwapSize() const; // Returns the size of the swap area for pages, 0 makes it four times max-overall-mem
+	int getSwapIOThreads() const; // Returns the number of swap I/O worker threads, 0 writes to the backing store on the evicting thread
+	int getSwapReadahead() const; // Returns the largest cluster of swap slots read around a major fault, 0 disables readahead
+	float getZswapPoolPercent() const; // Returns the share of max-overall-mem (percent) the compressed swap pool may hold, 0 disables the pool
+	std::string getAdmissionOrder() const; // Returns the order processes waiting for memory are admitted in ("fifo" or "smallest")
+	int getAdmissionQueueDepth() const; // Returns the processes that may wait for memory before creating one waits for room, 0 is unbounded
+	void setFlatFitPolicy(const std::string& policy); // Overrides the fit policy (used by the benchmarks)
+	void setMemoryShards(int shards); // Overrides the number of arenas (used by the benchmarks)
+	void setMaxOverallMemory(float memory); // Overrides the maximum overall memory (used by the benchmarks)
+	void setMemoryPerFrame(float memory); // Overrides the size of frames (used by the benchmarks)
+	void setPageTableType(const std::string& type); // Overrides the page table layout (used by the benchmarks)
+	void setHugePageSize(float size); // Overrides the huge page size (used by the benchmarks)
+	void setSwapSize(float size); // Overrides the swap area size (used by the benchmarks)
+	void setSwapIOThreads(int threads); // Overrides the swap I/O worker threads (used by the benchmarks)
+	void setSwapReadahead(int pages); // Overrides the swap readahead window (used by the benchmarks)
+	void setZswapPoolPercent(float percent); // Overrides the compressed swap pool size (used by the benchmarks)
 
 private:
 	void parseConfigFile();	// Parses the config file and sets the configuration values
 	void printConfig(); 	// Prints the configuration values to the console
+	static std::string stripQuotes(const std::string& value); // Removes surrounding quotes from a string value
 
 	bool initialized = false;
 		
@@ -43,5 +77,28 @@ private:
 	float minMemoryPerProcess;
 	float maxMemoryPerProcess;
 	std::string memoryManagerAlgorithm;
+	std::string flatFitPolicy;
+	int memoryShards;
+	std::string pageReplacementPolicy;
+	int pageFaultDelay;
+	std::string pageTableType;
+	int workingSetWindow;
+	float thrashFaultRate;
+	float reclaimLowWatermark;
+	float reclaimHighWatermark;
+	int tlbEntries;
+	int tlbWays;
+	bool tlbASIDTagged;
+	float hugePageSize;
+	int numaNodes;
+	std::string numaPlacement;
+	int numaRemoteDelay;
+	int numaMigrateAfter;
+	float swapSize;
+	int swapIOThreads;
+	int swapReadahead;
+	float zswapPoolPercent;
+	std::string admissionOrder;
+	int admissionQueueDepth;
 };
 
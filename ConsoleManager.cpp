@@ -118,6 +118,22 @@ void ConsoleManager::createProcessScreen(const std::string processName) {
 	switchScreen(processScreen->getName());
 }
 
+// Clone an existing process and open a screen for the clone
+void ConsoleManager::forkProcessScreen(const std::string parentName, const std::string processName) {
+
+	std::shared_ptr<Process> processPointer = resourceManager.forkProcess(parentName, processName); // Clone the parent process
+	if (!processPointer) {
+		std::cerr << "Process " << parentName << " not found." << std::endl;
+		return;
+	}
+
+	auto processScreen = std::make_shared<ProcessScreen>(processPointer); // Create a new ProcessScreen for the clone
+
+	addConsole(processScreen);                               // Add process screen to consoles map
+	// Switch to process screen
+	switchScreen(processScreen->getName());
+}
+
 // Display the status of resources (delegates to ResourceManager)
 void ConsoleManager::displayStatus() {
 	resourceManager.displayStatus();                         // Call displayStatus on the resourceManager
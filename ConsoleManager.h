@@ -24,6 +24,7 @@ public:
     void returnToPreviousScreen();
     ResourceManager& getResourceManager();
     void createProcessScreen(const std::string processName);
+    void forkProcessScreen(const std::string parentName, const std::string processName);
     void displayStatus();
     bool ifProcessExists(std::string name);
     bool isProcessFinished(std::string name);
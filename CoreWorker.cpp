@@ -2,6 +2,10 @@
 
 #include <iostream>
 
+namespace {
+    const size_t TLB_HIT_BATCH = 32; // hits reported to the memory manager at once
+}
+
 CoreWorker::CoreWorker(int id, float delayPerExec, float quantumSlice) 
     : id(id), running(false), processAssigned(false), delayPerExec(delayPerExec), quantumSlice(quantumSlice) {}
 
@@ -21,16 +25,26 @@ void CoreWorker::setProcess(std::shared_ptr<Process> process) {
     std::lock_guard<std::mutex> lock(coreMutex);
     currentProcess = process;
     processAssigned = true;
+
+    if (process && tlb.isEnabled()) {
+        tlb.contextSwitch(process->getID());
+    }
 }
 
 void CoreWorker::runProcess() {
+    // The memory callbacks are installed after the core started, the core thread only uses its own copies
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        activeMemoryAccessCallback = memoryAccessCallback;
+        activeTLBHitCallback = tlbHitCallback;
+    }
+
     // For FCFS
     if (quantumSlice == 0) {
         // While there is still a process, run
         while (currentProcess && !currentProcess->isFinished()) {
             totalActiveTicks++;
-            currentProcess->execute();
-            std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec));
+            executeInstruction();
         }
 
         // Process is finished, notify Scheduler
@@ -46,10 +60,10 @@ void CoreWorker::runProcess() {
                 finishProcess();
                 return;
             }
-            currentProcess->execute();
-            std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec));
+            executeInstruction();
         }
         totalActiveTicks++;
+        reportTLBHits(); // the hits belong to this process
         // Process is not finished, notify Scheduler
         if (processCompletionCallback) {
             processCompletionCallback(currentProcess);
@@ -61,11 +75,77 @@ void CoreWorker::runProcess() {
     }
 }
 
+void CoreWorker::executeInstruction() {
+    waitWhilePaused();
+
+    // The instruction's memory reference may fault, the process is blocked until the page is in
+    if (activeMemoryAccessCallback && currentProcess->getRemainingInstructions() > 0) {
+        // A TLB hit translates the address without walking the page table, the entry remembers the frame's node
+        int pageNumber = tlbPageSize > 0 ? currentProcess->getNextMemoryReference() / tlbPageSize : 0;
+        bool isWrite = currentProcess->isNextReferenceWrite();
+        MemoryAccess access = { 0, -1, true, true };
+        if (!tlb.isEnabled() || !tlb.lookup(currentProcess->getID(), pageNumber, isWrite, access.node)) {
+            reportTLBHits(); // the replacement policy sees the earlier references before this one
+
+            // Shootdowns are sent under the allocator lock, one that lands between the walk and the fill makes the fill stale
+            long long generation = tlb.isEnabled() ? tlb.getGeneration(currentProcess->getID(), pageNumber) : 0;
+            access = activeMemoryAccessCallback(currentProcess, numaNode);
+
+            if (tlb.isEnabled() && access.mapped) {
+                tlb.insert(currentProcess->getID(), pageNumber, isWrite && access.writable, access.node, generation); // the page is resident now, writable only once it is private
+            }
+        }
+        else {
+            // The page is still referenced, the working set and the replacement policy get the hits in batches
+            tlbHitAddresses.push_back(currentProcess->getNextMemoryReference());
+            if (tlbHitAddresses.size() >= TLB_HIT_BATCH) {
+                reportTLBHits();
+            }
+        }
+
+        // Memory attached to another node is slower to reach
+        if (access.node != -1) {
+            bool remote = access.node != numaNode;
+            currentProcess->recordMemoryAccess(remote);
+            if (remote) {
+                access.stallCycles += remoteAccessCycles;
+            }
+        }
+
+        if (access.stallCycles > 0) {
+            totalStallTicks += access.stallCycles;
+            std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec * access.stallCycles));
+        }
+    }
+
+    totalInstructions++;
+    currentProcess->execute();
+    std::this_thread::sleep_for(std::chrono::duration<float>(delayPerExec));
+}
+
+void CoreWorker::reportTLBHits() {
+    if (!tlbHitAddresses.empty() && activeTLBHitCallback) {
+        activeTLBHitCallback(currentProcess, tlbHitAddresses);
+    }
+    tlbHitAddresses.clear();
+}
 
 void CoreWorker::finishProcess() {
-    std::lock_guard<std::mutex> lock(coreMutex);
-    currentProcess.reset(); // Reset the current process
-    processAssigned = false; // No more process assigned
+    reportTLBHits(); // before the process's memory is released
+    std::shared_ptr<Process> finishedProcess;
+    std::function<void(std::shared_ptr<Process>)> callback;
+    {
+        std::lock_guard<std::mutex> lock(coreMutex);
+        finishedProcess = currentProcess;
+        callback = processCompletionCallback;
+        currentProcess.reset(); // Reset the current process
+        processAssigned = false; // No more process assigned
+    }
+
+    // The core is free again, the scheduler releases the process's memory
+    if (callback && finishedProcess) {
+        callback(finishedProcess);
+    }
 }
 
 bool CoreWorker::isAvailable() {
@@ -93,6 +173,7 @@ void CoreWorker::stop() {
         std::lock_guard<std::mutex> lock(coreMutex);
         running = false;
     }
+    resume(); // a parked core has to see that it stopped
     if (coreThread.joinable()) {
         coreThread.join();
     }
@@ -107,6 +188,7 @@ void CoreWorker::run() {
                 break;
             }
         }
+        waitWhilePaused();
         totalCPUTicks++;
         if (processAssigned) {
             runProcess();
@@ -118,12 +200,73 @@ void CoreWorker::run() {
     }
 }
 
+void CoreWorker::pause() {
+    std::unique_lock<std::mutex> lock(pauseMutex);
+    pauseRequested = true;
+    if (coreThread.joinable()) {
+        pauseChanged.wait(lock, [this] { return parked; });
+    }
+}
+
+void CoreWorker::resume() {
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        pauseRequested = false;
+    }
+    pauseChanged.notify_all();
+}
+
+void CoreWorker::waitWhilePaused() {
+    if (!pauseRequested) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(pauseMutex);
+    parked = true;
+    pauseChanged.notify_all();
+    pauseChanged.wait(lock, [this] { return !pauseRequested; });
+    parked = false;
+}
+
 // Set the process completion callback
 void CoreWorker::setProcessCompletionCallback(std::function<void(std::shared_ptr<Process>)> callback) {
     std::lock_guard<std::mutex> lock(coreMutex);
     processCompletionCallback = callback;
 }
 
+// Set the memory access callback
+void CoreWorker::setMemoryAccessCallback(std::function<MemoryAccess(std::shared_ptr<Process>, int)> callback) {
+    std::lock_guard<std::mutex> lock(coreMutex);
+    memoryAccessCallback = callback;
+}
+
+void CoreWorker::setTLBHitCallback(std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> callback) {
+    std::lock_guard<std::mutex> lock(coreMutex);
+    tlbHitCallback = callback;
+}
+
 std::vector<long long> CoreWorker::getStats() {
-    return { totalCPUTicks, totalActiveTicks, totalIdleTicks };
+    return { totalCPUTicks, totalActiveTicks, totalIdleTicks, totalStallTicks };
+}
+
+void CoreWorker::configureTLB(int numEntries, int ways, bool asidTagged, int pageSize) {
+    tlb.configure(numEntries, ways, asidTagged);
+    tlbPageSize = pageSize;
+}
+
+void CoreWorker::invalidateTLBEntry(int pid, int pageNumber) {
+    tlb.invalidate(pid, pageNumber);
+}
+
+std::vector<long long> CoreWorker::getTLBStats() {
+    return { tlb.getNumHits(), tlb.getNumMisses(), tlb.getNumFlushes(), totalInstructions };
+}
+
+void CoreWorker::configureNUMA(int node, int cycles) {
+    numaNode = node;
+    remoteAccessCycles = cycles;
+}
+
+int CoreWorker::getNUMANode() const {
+    return numaNode;
 }
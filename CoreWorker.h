@@ -3,12 +3,22 @@
 #include <thread>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <functional>
 #include <vector>
 
 #include "Process.h"
+#include "TLB.h"
 
 
+// Result of a memory reference that missed the TLB
+struct MemoryAccess {
+    int stallCycles; // cycles the process is blocked for by a page fault
+    int node; // NUMA node of the frame that holds the page, -1 if memory is not paged
+    bool mapped; // the page is resident, the core may cache its translation in the TLB
+    bool writable; // the frame is private to the process, writes may go through a cached translation
+};
 
 class CoreWorker
 {
@@ -27,11 +37,22 @@ public:
 
     void start();
     void stop();
+    void pause(); // returns once the core is parked between two instructions, for checkpoints
+    void resume();
 
     void setProcessCompletionCallback(std::function<void(std::shared_ptr<Process>)> callback);
+    void setMemoryAccessCallback(std::function<MemoryAccess(std::shared_ptr<Process>, int)> callback); // gets the core's NUMA node
+    void setTLBHitCallback(std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> callback); // addresses that hit the TLB, reported in batches
 
     std::vector<long long> getStats();
 
+    void configureTLB(int numEntries, int ways, bool asidTagged, int pageSize); // only used in paging mode
+    void invalidateTLBEntry(int pid, int pageNumber); // TLB shootdown when a page is evicted
+    std::vector<long long> getTLBStats(); // hits, misses, flushes, instructions executed
+
+    void configureNUMA(int node, int remoteAccessCycles); // only used in paging mode
+    int getNUMANode() const;
+
 private:
     int id;
     std::thread coreThread;
@@ -40,15 +61,36 @@ private:
     std::mutex coreMutex;
     std::shared_ptr<Process> currentProcess;
 
+    std::mutex pauseMutex;
+    std::condition_variable pauseChanged;
+    std::atomic<bool> pauseRequested{ false };
+    bool parked = false;
+
     float delayPerExec = 0;
     float quantumSlice = 0;
 
     void run();
+    void executeInstruction(); // runs one instruction of the current process, stalling on page faults
+    void waitWhilePaused(); // pause point, the process's state is consistent here
     std::function<void(std::shared_ptr<Process>)> processCompletionCallback;
+    std::function<MemoryAccess(std::shared_ptr<Process>, int)> memoryAccessCallback; // guarded by coreMutex
+    std::function<MemoryAccess(std::shared_ptr<Process>, int)> activeMemoryAccessCallback; // copy taken by runProcess
+    std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> tlbHitCallback; // guarded by coreMutex
+    std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> activeTLBHitCallback; // copy taken by runProcess
 
     // Stat trackers
     long long totalCPUTicks = 0;
     long long totalActiveTicks = 0;
     long long totalIdleTicks = 0;
+    long long totalStallTicks = 0; // cycles spent blocked on page faults and remote memory
+    long long totalInstructions = 0;
+
+    TLB tlb;
+    int tlbPageSize = 0;
+    std::vector<int> tlbHitAddresses; // hits of the current process not reported yet, a hit skips the page table walk that records the reference
+    void reportTLBHits();
+
+    int numaNode = 0; // node whose memory is local to this core
+    int remoteAccessCycles = 0; // extra cycles of every reference to another node's memory
 
 };
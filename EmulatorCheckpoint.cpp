@@ -0,0 +1,163 @@
+#include "EmulatorCheckpoint.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <cstring>
+
+namespace {
+    const uint32_t CHECKPOINT_MAGIC = 0x54504B43; // "CKPT"
+    const uint32_t CHECKPOINT_VERSION = 1;
+
+    void copyField(char* field, size_t fieldSize, const std::string& value) {
+        std::memset(field, 0, fieldSize);
+        std::memcpy(field, value.data(), value.size() < fieldSize ? value.size() : fieldSize - 1);
+    }
+
+    std::string readField(const char* field, size_t fieldSize) {
+        return std::string(field, strnlen(field, fieldSize));
+    }
+}
+
+size_t EmulatorCheckpoint::getFileSize(const Contents& contents) {
+    size_t size = sizeof(Header) + contents.processes.size() * sizeof(ProcessRecord);
+    for (const auto& entry : contents.processes) {
+        size += entry.residentPages.size() * sizeof(PageRecord) + entry.name.size();
+    }
+    return size;
+}
+
+bool EmulatorCheckpoint::save(const std::string& filename, const Contents& contents) {
+    size_t size = getFileSize(contents);
+    MappedFile file;
+    if (!file.open(filename, size) || (file.size() != size && !file.resize(size))) {
+        return false;
+    }
+
+    uint32_t numPages = 0;
+    for (const auto& entry : contents.processes) {
+        numPages += static_cast<uint32_t>(entry.residentPages.size());
+    }
+
+    Header* header = reinterpret_cast<Header*>(file.data());
+    ProcessRecord* records = reinterpret_cast<ProcessRecord*>(file.data() + sizeof(Header));
+    PageRecord* pages = reinterpret_cast<PageRecord*>(records + contents.processes.size());
+    char* names = reinterpret_cast<char*>(pages + numPages);
+
+    // The magic goes in last, a checkpoint cut short is never taken for a complete one
+    std::memset(header, 0, sizeof(Header));
+    uint32_t nextPage = 0;
+    uint32_t namesSize = 0;
+    for (size_t i = 0; i < contents.processes.size(); ++i) {
+        const ProcessEntry& entry = contents.processes[i];
+        ProcessRecord& record = records[i];
+        std::memset(&record, 0, sizeof(ProcessRecord));
+        record.state = entry.state;
+        record.location = static_cast<int32_t>(entry.location);
+        record.position = entry.position;
+        record.swappedOut = entry.swappedOut ? 1 : 0;
+        record.firstPage = nextPage;
+        record.numPages = static_cast<uint32_t>(entry.residentPages.size());
+        record.nameOffset = namesSize;
+        record.nameLength = static_cast<uint32_t>(entry.name.size());
+
+        for (const auto& page : entry.residentPages) {
+            pages[nextPage].pageNumber = page.first;
+            pages[nextPage].node = page.second;
+            ++nextPage;
+        }
+        std::memcpy(names + namesSize, entry.name.data(), entry.name.size());
+        namesSize += record.nameLength;
+    }
+
+    header->version = CHECKPOINT_VERSION;
+    header->processRecordSize = sizeof(ProcessRecord);
+    header->numProcesses = static_cast<uint32_t>(contents.processes.size());
+    header->numPages = numPages;
+    header->namesSize = namesSize;
+    header->processCounter = contents.processCounter;
+    header->schedulerCounter = contents.schedulerCounter;
+    header->numCPU = contents.numCPU;
+    header->maxOverallMemory = contents.maxOverallMemory;
+    header->memoryPerFrame = contents.memoryPerFrame;
+    copyField(header->memoryManager, sizeof(header->memoryManager), contents.memoryManager);
+    copyField(header->scheduler, sizeof(header->scheduler), contents.scheduler);
+    file.flush();
+    header->magic = CHECKPOINT_MAGIC;
+    file.flush(0, sizeof(Header));
+    return true;
+}
+
+bool EmulatorCheckpoint::load(const std::string& filename, Contents& contents, std::string& error) {
+    // Mapping would create a missing file, check it first
+    size_t fileSize = 0;
+    {
+        std::ifstream probe(filename, std::ios::binary | std::ios::ate);
+        if (!probe) {
+            error = "Cannot open " + filename + ".";
+            return false;
+        }
+        fileSize = static_cast<size_t>(probe.tellg());
+    }
+    if (fileSize < sizeof(Header)) {
+        error = filename + " is not a checkpoint.";
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(filename, sizeof(Header))) {
+        error = "Cannot map " + filename + ".";
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(file.data());
+    if (header->magic != CHECKPOINT_MAGIC || header->processRecordSize != sizeof(ProcessRecord)) {
+        error = filename + " is not a checkpoint.";
+        return false;
+    }
+    if (header->version != CHECKPOINT_VERSION) {
+        error = filename + " was written by another version of the emulator.";
+        return false;
+    }
+    size_t expectedSize = sizeof(Header) + static_cast<size_t>(header->numProcesses) * sizeof(ProcessRecord)
+        + static_cast<size_t>(header->numPages) * sizeof(PageRecord) + header->namesSize;
+    if (file.size() != expectedSize) {
+        error = filename + " is truncated.";
+        return false;
+    }
+
+    const ProcessRecord* records = reinterpret_cast<const ProcessRecord*>(file.data() + sizeof(Header));
+    const PageRecord* pages = reinterpret_cast<const PageRecord*>(records + header->numProcesses);
+    const char* names = reinterpret_cast<const char*>(pages + header->numPages);
+
+    contents.memoryManager = readField(header->memoryManager, sizeof(header->memoryManager));
+    contents.scheduler = readField(header->scheduler, sizeof(header->scheduler));
+    contents.numCPU = header->numCPU;
+    contents.maxOverallMemory = header->maxOverallMemory;
+    contents.memoryPerFrame = header->memoryPerFrame;
+    contents.processCounter = header->processCounter;
+    contents.schedulerCounter = header->schedulerCounter;
+    contents.processes.clear();
+    contents.processes.reserve(header->numProcesses);
+
+    for (uint32_t i = 0; i < header->numProcesses; ++i) {
+        const ProcessRecord& record = records[i];
+        if (static_cast<size_t>(record.firstPage) + record.numPages > header->numPages
+            || static_cast<size_t>(record.nameOffset) + record.nameLength > header->namesSize
+            || record.location < 0 || record.location > static_cast<int32_t>(Location::Finished)) {
+            error = filename + " is corrupt.";
+            return false;
+        }
+
+        ProcessEntry entry;
+        entry.name.assign(names + record.nameOffset, record.nameLength);
+        entry.state = record.state;
+        entry.location = static_cast<Location>(record.location);
+        entry.position = record.position;
+        entry.swappedOut = record.swappedOut != 0;
+        entry.residentPages.reserve(record.numPages);
+        for (uint32_t page = record.firstPage; page < record.firstPage + record.numPages; ++page) {
+            entry.residentPages.emplace_back(pages[page].pageNumber, pages[page].node);
+        }
+        contents.processes.push_back(std::move(entry));
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "Process.h"
+
+// Snapshot of the whole emulator in one binary file, for warm starts (checkpoint and restore)
+// Layout: header, one fixed-size record per process, the resident pages of every process, then the process names
+// Loading maps the file and reads the records in place, only the names and page lists are copied out
+class EmulatorCheckpoint
+{
+public:
+	// Where a process was when the checkpoint was taken
+	enum class Location { Admission, NotAdmitted, Ready, Running, Finished };
+
+	struct ProcessEntry {
+		std::string name;
+		Process::State state;
+		Location location;
+		int position; // place in the admission list or the ready queue, core ID if running
+		bool swappedOut; // flat and buddy, the process only lives in the backing store
+		std::vector<std::pair<int, int>> residentPages; // paging, (page number, NUMA node)
+	};
+
+	struct Contents {
+		// Configuration the checkpoint was taken with, a restore needs the same one
+		std::string memoryManager;
+		std::string scheduler;
+		int numCPU;
+		int maxOverallMemory;
+		int memoryPerFrame;
+
+		int processCounter; // last process ID handed out
+		int schedulerCounter; // processes created by scheduler-test
+		std::vector<ProcessEntry> processes; // in creation order, a clone comes after its parent
+	};
+
+	static bool save(const std::string& filename, const Contents& contents); // false if the file could not be written
+	static bool load(const std::string& filename, Contents& contents, std::string& error); // false with the reason if the file is missing or not a checkpoint
+	static size_t getFileSize(const Contents& contents);
+
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t processRecordSize;
+		uint32_t numProcesses;
+		uint32_t numPages;
+		uint32_t namesSize;
+		int32_t processCounter;
+		int32_t schedulerCounter;
+		int32_t numCPU;
+		int32_t maxOverallMemory;
+		int32_t memoryPerFrame;
+		char memoryManager[16]; // null-terminated
+		char scheduler[16];
+		uint32_t reserved[5];
+	};
+
+	struct ProcessRecord {
+		Process::State state;
+		int32_t location;
+		int32_t position;
+		int32_t swappedOut;
+		uint32_t firstPage; // into the page records
+		uint32_t numPages;
+		uint32_t nameOffset; // into the names
+		uint32_t nameLength;
+		int32_t reserved;
+	};
+
+	struct PageRecord {
+		int32_t pageNumber;
+		int32_t node;
+	};
+};
@@ -1,15 +1,33 @@
 #include "FlatAllocator.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 
-FlatAllocator::FlatAllocator() {
+FlatAllocator::FlatAllocator()
+    : configManager(nullptr), memoryBase(0), memorySize(0), freeMemory(0), fitPolicy("first"), nextFitStart(0),
+      numCompactions(0), numBlocksMoved(0), memoryMoved(0), compactionTime(0) {
     srand(static_cast<unsigned int>(time(nullptr))); // Initialize random seed once
 }
 
 void FlatAllocator::initialize(ConfigurationManager* newConfigManager) {
+    initialize(newConfigManager, 0, static_cast<int>(newConfigManager->getMaxOverallMemory()));
+}
+
+void FlatAllocator::initialize(ConfigurationManager* newConfigManager, int base, int size) {
     configManager = newConfigManager;
-    memorySize = static_cast<int>(configManager->getMaxOverallMemory());
-    memoryBlocks.push_back({ 0, memorySize, true }); // Initialize with a single free block of the entire memory
+    memoryBase = base;
+    memorySize = size;
+    fitPolicy = configManager->getFlatFitPolicy();
+    nextFitStart = base;
+
+    memoryBlocks.clear();
+    processMemoryMap.clear();
+    freeBlocksByAddress.clear();
+    freeBlocksBySize.clear();
+    freeMemory = 0;
+
+    memoryBlocks[memoryBase] = { memoryBase, memorySize, true, -1 }; // Initialize with a single free block of the entire memory
+    addFreeBlock(memoryBase, memorySize);
 }
 
 void printBlockInfo(const MemoryBlock& block) {
@@ -18,48 +36,79 @@ void printBlockInfo(const MemoryBlock& block) {
         << "\nStatus: " << (block.isFree ? "Free" : "Allocated") << std::endl << std::endl;
 }
 
-bool FlatAllocator::allocate(Process process) {
-    int processSize = static_cast<int>(process.getMemorySize());
+void FlatAllocator::addFreeBlock(int start, int size) {
+    freeBlocksByAddress.insert(start, size);
+    freeBlocksBySize.insert({ size, start });
+    freeMemory += size;
+}
+
+void FlatAllocator::removeFreeBlock(int start, int size) {
+    freeBlocksByAddress.erase(start);
+    freeBlocksBySize.erase({ size, start });
+    freeMemory -= size;
+}
 
-    for (auto& block : memoryBlocks) {
+int FlatAllocator::findFreeBlock(int size) {
+    if (fitPolicy == "best") {
+        // smallest free block that still fits, lowest address on ties
+        auto it = freeBlocksBySize.lower_bound({ size, -1 });
+        return it != freeBlocksBySize.end() ? it->second : -1;
+    }
+    else if (fitPolicy == "next") {
+        // continue from where the last allocation ended, wrap around if nothing fits
+        int start = freeBlocksByAddress.findFirstFitFrom(nextFitStart, size);
+        return start != -1 ? start : freeBlocksByAddress.findFirstFit(size);
+    }
+    return freeBlocksByAddress.findFirstFit(size);
+}
 
-        // check if block is free and has enough space for the process
-        if (block.isFree && block.size >= processSize) {
+bool FlatAllocator::allocate(Process process) {
+    int processSize = static_cast<int>(process.getMemorySize());
 
-            int currBlockSize = block.size;
+    int start = findFreeBlock(processSize);
+    if (start == -1) {
+        return false; // no sufficient free block found
+    }
 
-            block.isFree = false;
-            block.size = process.getMemorySize();
+    MemoryBlock& block = memoryBlocks[start];
+    int currBlockSize = block.size;
+    removeFreeBlock(block.start, block.size);
 
-            processMemoryMap[process.getID()] = block.start;
+    block.isFree = false;
+    block.size = processSize;
+    block.pid = process.getID();
 
-            // split block if it has more space than the process
-            if (currBlockSize > process.getMemorySize()) {
-                memoryBlocks.push_back({ block.start + ((int)process.getMemorySize()), currBlockSize - ((int)process.getMemorySize()), true });
-            }
+    processMemoryMap[process.getID()] = block.start;
 
-            return true;
-        }
+    // split block if it has more space than the process
+    if (currBlockSize > processSize) {
+        int remainderStart = start + processSize;
+        memoryBlocks[remainderStart] = { remainderStart, currBlockSize - processSize, true, -1 };
+        addFreeBlock(remainderStart, currBlockSize - processSize);
     }
-    return false; // no sufficient free block found
+
+    nextFitStart = start + processSize;
+    return true;
 }
 
-void FlatAllocator::deallocate(int pid) {
+bool FlatAllocator::deallocate(int pid) {
     auto it = processMemoryMap.find(pid);
 
     // find block with the process
-    if (it != processMemoryMap.end()) {
-        for (auto& block : memoryBlocks) {
-
-            // check if block is the one with the process
-            if (block.start == it->second) {
-                block.isFree = true;
-                processMemoryMap.erase(it);
-                mergeFreeBlocks(); // Merge adjacent free blocks after deallocation
-                break;
-            }
-        }
+    if (it == processMemoryMap.end()) {
+        return false;
+    }
+
+    auto block = memoryBlocks.find(it->second);
+    processMemoryMap.erase(it);
+
+    if (block != memoryBlocks.end()) {
+        block->second.isFree = true;
+        block->second.pid = -1;
+        addFreeBlock(block->second.start, block->second.size);
+        mergeFreeBlocks(block); // Merge adjacent free blocks after deallocation
     }
+    return true;
 }
 
 int FlatAllocator::swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs) {
@@ -84,42 +133,140 @@ int FlatAllocator::swapOutRandomProcess(const std::unordered_set<int>& runningPr
     return pid;
 }
 
-void FlatAllocator::mergeFreeBlocks() {
+void FlatAllocator::mergeFreeBlocks(std::map<int, MemoryBlock>::iterator block) {
+
+    // Merge with the next block if it is free (blocks are contiguous since the map covers all of memory)
+    auto next = std::next(block);
+    if (next != memoryBlocks.end() && next->second.isFree) {
+        removeFreeBlock(block->second.start, block->second.size);
+        removeFreeBlock(next->second.start, next->second.size);
+
+        block->second.size += next->second.size;
+        memoryBlocks.erase(next);
+        addFreeBlock(block->second.start, block->second.size);
+    }
 
-    // Sort memory blocks by start address
-    std::sort(memoryBlocks.begin(), memoryBlocks.end(), [](const MemoryBlock& a, const MemoryBlock& b) {
-        return a.start < b.start;
-        });
+    // Merge into the previous block if it is free
+    if (block != memoryBlocks.begin()) {
+        auto prev = std::prev(block);
+        if (prev->second.isFree) {
+            removeFreeBlock(prev->second.start, prev->second.size);
+            removeFreeBlock(block->second.start, block->second.size);
 
-    // Iterate through memory blocks and merge adjacent free blocks
-    for (size_t i = 0; i < memoryBlocks.size() - 1; ++i) {
-        if (memoryBlocks[i].isFree && memoryBlocks[i + 1].isFree) { // Check if current block and next block are free
-            if (memoryBlocks[i].start + memoryBlocks[i].size == memoryBlocks[i + 1].start) { // Check if blocks are contiguous (magkatabi)
-                memoryBlocks[i].size += memoryBlocks[i + 1].size; // Merge blocks by adding their sizes onto current block
-                memoryBlocks.erase(memoryBlocks.begin() + i + 1); // Erase next block
-                --i; // Check again in case there are multiple contiguous free blocks
-            }
+            prev->second.size += block->second.size;
+            memoryBlocks.erase(block);
+            addFreeBlock(prev->second.start, prev->second.size);
         }
     }
 }
 
+bool FlatAllocator::moveNextBlock() {
+    int freeStart = freeBlocksByAddress.findFirstFit(1); // lowest free block
+    if (freeStart == -1) {
+        return false;
+    }
+
+    auto freeBlock = memoryBlocks.find(freeStart);
+    auto usedBlock = std::next(freeBlock);
+    if (usedBlock == memoryBlocks.end()) {
+        return false; // free space is already at the end of memory
+    }
+
+    // Free blocks are always merged, so the block after a free block is allocated
+    MemoryBlock moved = usedBlock->second;
+    int freeSize = freeBlock->second.size;
+    removeFreeBlock(freeStart, freeSize);
+    memoryBlocks.erase(usedBlock);
+
+    // Slide the process down and put the free space right after it
+    moved.start = freeStart;
+    freeBlock->second = moved;
+    processMemoryMap[moved.pid] = moved.start;
+
+    int newFreeStart = freeStart + moved.size;
+    auto newFreeBlock = memoryBlocks.insert({ newFreeStart, { newFreeStart, freeSize, true, -1 } }).first;
+    addFreeBlock(newFreeStart, freeSize);
+    mergeFreeBlocks(newFreeBlock);
+
+    ++numBlocksMoved;
+    memoryMoved += moved.size;
+    return true;
+}
+
+int FlatAllocator::compact(int maxMoves) {
+    auto start = std::chrono::steady_clock::now();
+
+    int moves = 0;
+    while (moves < maxMoves && moveNextBlock()) {
+        ++moves;
+    }
+
+    if (moves > 0) {
+        ++numCompactions;
+        compactionTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    return moves;
+}
+
+bool FlatAllocator::compactFor(int size) {
+    if (freeMemory < size) {
+        return false; // compaction cannot help, swapping is needed
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int moves = 0;
+    while (getLargestFreeBlock() < size && moveNextBlock()) {
+        ++moves;
+    }
+
+    if (moves > 0) {
+        ++numCompactions;
+        compactionTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    return getLargestFreeBlock() >= size;
+}
+
 void FlatAllocator::displayMemory() {
     std::cout << "Memory Blocks:" << std::endl;
-    for (const auto& block : memoryBlocks) {
-        std::cout << "Start: " << block.start
-            << "\nSize: " << block.size
-            << "\nStatus: " << (block.isFree ? "Free" : "Allocated") << std::endl << std::endl;
+    for (const auto& entry : memoryBlocks) {
+        printBlockInfo(entry.second);
     }
 
 }
 
 // Total Memory allocated (active + inacive)
-int FlatAllocator::getUsedMemory() {
-    int usedMemory = 0;
-    for (const auto& block : memoryBlocks) {
-        if (!block.isFree) {
-            usedMemory += block.size;
-        }
+int FlatAllocator::getUsedMemory() const {
+    return memorySize - freeMemory;
+}
+
+int FlatAllocator::getFreeMemory() const {
+    return freeMemory;
+}
+
+int FlatAllocator::getLargestFreeBlock() const {
+    return freeBlocksByAddress.getLargestSize();
+}
+
+float FlatAllocator::getExternalFragmentation() const {
+    if (freeMemory == 0) {
+        return 0;
     }
-    return usedMemory;
+    return (1.0f - static_cast<float>(getLargestFreeBlock()) / freeMemory) * 100;
+}
+
+long long FlatAllocator::getNumCompactions() const {
+    return numCompactions;
+}
+
+long long FlatAllocator::getNumBlocksMoved() const {
+    return numBlocksMoved;
+}
+
+long long FlatAllocator::getMemoryMoved() const {
+    return memoryMoved;
+}
+
+long long FlatAllocator::getCompactionTime() const {
+    return compactionTime;
 }
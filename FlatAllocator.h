@@ -1,17 +1,22 @@
 #pragma once
 
 #include <vector>
+#include <map>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
 
 #include "Process.h"
 #include "ConfigurationManager.h"
+#include "FreeBlockTree.h"
 
 // MemoryBlock struct (for flat alloc)
 struct MemoryBlock {
 	int start;	// start address of the block
 	int size;	// size of the block
 	bool isFree;	// is the block free?
+	int pid;	// process in the block, -1 if free
 };
 
 class FlatAllocator
@@ -20,19 +25,48 @@ public:
 	FlatAllocator();
 
 	void initialize(ConfigurationManager* configManager); // initialize memory blocks
+	void initialize(ConfigurationManager* configManager, int base, int size); // manage only [base, base + size) (one arena of ShardedFlatAllocator)
 	bool allocate(Process process);	// allocate memory for a process
-	void deallocate(int pid);
+	bool deallocate(int pid); // false if the process has no block here
 	int swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs); // swap out a random process
 	void displayMemory();
 
-	int getUsedMemory(); // returns active + idle processes 
+	int getUsedMemory() const; // returns active + idle processes, safe to call without the allocator lock
+	int getFreeMemory() const; // total free memory, contiguous or not, safe to call without the allocator lock
+	int getLargestFreeBlock() const; // size of the largest free block
+	float getExternalFragmentation() const; // percentage of free memory that is not in the largest free block
+
+	int compact(int maxMoves); // slide up to maxMoves allocated blocks down into free space, returns blocks moved
+	bool compactFor(int size); // compact until a free block of this size exists, false if there is not enough free memory
+
+	// Compaction stats
+	long long getNumCompactions() const;
+	long long getNumBlocksMoved() const;
+	long long getMemoryMoved() const;
+	long long getCompactionTime() const; // microseconds spent compacting
 
 private:
 	ConfigurationManager* configManager;
-	std::vector<MemoryBlock> memoryBlocks; // memory blocks
-	std::unordered_map<int, int> processMemoryMap; // memory block index
+	std::map<int, MemoryBlock> memoryBlocks; // memory blocks ordered by start address
+	std::unordered_map<int, int> processMemoryMap; // pid -> start address of its block
+	int memoryBase;	// first address of the managed memory
 	int memorySize;	// total memory size
+	std::atomic<int> freeMemory; // total size of free blocks
 
-	void mergeFreeBlocks(); // merge adjacent free blocks
-};
+	std::string fitPolicy; // "first", "best" or "next"
+	int nextFitStart; // where the next-fit search resumes
 
+	FreeBlockTree freeBlocksByAddress; // free blocks by address (first-fit, next-fit)
+	std::set<std::pair<int, int>> freeBlocksBySize; // free blocks by (size, start) (best-fit)
+
+	int findFreeBlock(int size); // start of a free block that fits, using the fit policy
+	void addFreeBlock(int start, int size);
+	void removeFreeBlock(int start, int size);
+	void mergeFreeBlocks(std::map<int, MemoryBlock>::iterator block); // merge a free block with its free neighbors
+	bool moveNextBlock(); // move the allocated block after the lowest free block into it
+
+	std::atomic<long long> numCompactions;
+	std::atomic<long long> numBlocksMoved;
+	std::atomic<long long> memoryMoved;
+	std::atomic<long long> compactionTime;
+};
@@ -0,0 +1,166 @@
+#include "FrameBitmap.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+FrameBitmap::FrameBitmap() : numBits(0), numSet(0), firstSetHint(0) {}
+
+int FrameBitmap::countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+void FrameBitmap::resize(int newNumBits, bool value) {
+    numBits = newNumBits;
+    int numWords = (numBits + 63) / 64;
+    words.assign(numWords, value ? ~uint64_t(0) : 0);
+    summary.assign((numWords + 63) / 64, 0);
+
+    if (value) {
+        // clear the unused bits of the last word so they are never found
+        if (numBits % 64 != 0) {
+            words.back() = (uint64_t(1) << (numBits % 64)) - 1;
+        }
+        for (int word = 0; word < numWords; ++word) {
+            summary[word / 64] |= uint64_t(1) << (word % 64);
+        }
+    }
+
+    numSet = value ? numBits : 0;
+    firstSetHint = 0;
+}
+
+void FrameBitmap::set(int index) {
+    uint64_t& word = words[index / 64];
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (word & bit) {
+        return;
+    }
+
+    word |= bit;
+    summary[index / 4096] |= uint64_t(1) << ((index / 64) % 64);
+    ++numSet;
+    if (index / 64 < firstSetHint) {
+        firstSetHint = index / 64;
+    }
+}
+
+void FrameBitmap::clear(int index) {
+    uint64_t& word = words[index / 64];
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if (!(word & bit)) {
+        return;
+    }
+
+    word &= ~bit;
+    if (word == 0) {
+        summary[index / 4096] &= ~(uint64_t(1) << ((index / 64) % 64));
+    }
+    --numSet;
+}
+
+bool FrameBitmap::test(int index) const {
+    return (words[index / 64] >> (index % 64)) & 1;
+}
+
+int FrameBitmap::findFirstSetWord(int startWord) const {
+    int numWords = static_cast<int>(words.size());
+    if (startWord >= numWords) {
+        return -1;
+    }
+
+    // check the rest of the summary word that startWord is in
+    int summaryIndex = startWord / 64;
+    uint64_t masked = summary[summaryIndex] & (~uint64_t(0) << (startWord % 64));
+    if (masked) {
+        return summaryIndex * 64 + countTrailingZeros(masked);
+    }
+
+    for (++summaryIndex; summaryIndex < static_cast<int>(summary.size()); ++summaryIndex) {
+        if (summary[summaryIndex]) {
+            return summaryIndex * 64 + countTrailingZeros(summary[summaryIndex]);
+        }
+    }
+    return -1;
+}
+
+int FrameBitmap::findFirstSet() const {
+    if (numSet == 0) {
+        return -1;
+    }
+
+    int word = findFirstSetWord(firstSetHint);
+    if (word == -1) {
+        return -1;
+    }
+    firstSetHint = word; // everything below is empty, later searches can start here
+    return word * 64 + countTrailingZeros(words[word]);
+}
+
+int FrameBitmap::findFirstSetFrom(int start) const {
+    if (start >= numBits || numSet == 0) {
+        return -1;
+    }
+    if (start < 0) {
+        start = 0;
+    }
+
+    // check the rest of the word that start is in
+    uint64_t masked = words[start / 64] & (~uint64_t(0) << (start % 64));
+    if (masked) {
+        return (start / 64) * 64 + countTrailingZeros(masked);
+    }
+
+    int word = findFirstSetWord(start / 64 + 1);
+    return word == -1 ? -1 : word * 64 + countTrailingZeros(words[word]);
+}
+
+int FrameBitmap::findAlignedRun(int length) const {
+    if (length <= 1) {
+        return findFirstSet();
+    }
+    if (numSet < length) {
+        return -1;
+    }
+
+    int numWords = static_cast<int>(words.size());
+    if (length < 64) {
+        // an aligned run never crosses a word, so only words with a set bit are checked
+        uint64_t mask = (uint64_t(1) << length) - 1;
+        for (int word = findFirstSetWord(firstSetHint); word != -1; word = findFirstSetWord(word + 1)) {
+            for (int bit = 0; bit < 64; bit += length) {
+                if (((words[word] >> bit) & mask) == mask) {
+                    return word * 64 + bit;
+                }
+            }
+        }
+        return -1;
+    }
+
+    // longer runs are whole words that are all set
+    int wordsPerRun = length / 64;
+    for (int word = 0; word + wordsPerRun <= numWords; word += wordsPerRun) {
+        int full = 0;
+        while (full < wordsPerRun && words[word + full] == ~uint64_t(0)) {
+            ++full;
+        }
+        if (full == wordsPerRun) {
+            return word * 64;
+        }
+    }
+    return -1;
+}
+
+int FrameBitmap::count() const {
+    return numSet;
+}
+
+int FrameBitmap::size() const {
+    return numBits;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Two-level bitmap of frames (for paging alloc)
+// A summary word marks which 64-bit words have any bit set, so find-first-set skips empty words 4096 frames at a time
+class FrameBitmap
+{
+public:
+	FrameBitmap();
+
+	void resize(int numBits, bool value); // resize and set every bit to value
+	void set(int index);
+	void clear(int index);
+	bool test(int index) const;
+
+	int findFirstSet() const; // lowest set bit, -1 if none
+	int findFirstSetFrom(int start) const; // lowest set bit at or after start, -1 if none
+	int findAlignedRun(int length) const; // lowest run of length set bits starting at a multiple of length (a power of two), -1 if none
+	int count() const; // number of set bits
+	int size() const;
+
+private:
+	std::vector<uint64_t> words;	// one bit per frame
+	std::vector<uint64_t> summary;	// one bit per word, set if the word is not zero
+	int numBits;
+	int numSet;
+	mutable int firstSetHint;	// no bit is set below this word
+
+	static int countTrailingZeros(uint64_t value);
+	int findFirstSetWord(int startWord) const; // first word at or after startWord with a set bit, -1 if none
+};
@@ -0,0 +1,145 @@
+#include "FreeBlockTree.h"
+#include <algorithm>
+
+FreeBlockTree::FreeBlockTree() : root(-1), seed(2463534242u) {}
+
+int FreeBlockTree::newNode(int start, int size) {
+    Node node = { start, size, size, nextPriority(), -1, -1 };
+
+    // reuse a freed slot if there is one
+    if (!freeNodes.empty()) {
+        int index = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[index] = node;
+        return index;
+    }
+
+    nodes.push_back(node);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+// xorshift, good enough for treap priorities
+unsigned int FreeBlockTree::nextPriority() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+void FreeBlockTree::update(int node) {
+    Node& n = nodes[node];
+    n.maxSize = n.size;
+    if (n.left != -1) {
+        n.maxSize = std::max(n.maxSize, nodes[n.left].maxSize);
+    }
+    if (n.right != -1) {
+        n.maxSize = std::max(n.maxSize, nodes[n.right].maxSize);
+    }
+}
+
+int FreeBlockTree::merge(int left, int right) {
+    if (left == -1) return right;
+    if (right == -1) return left;
+
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    else {
+        nodes[right].left = merge(left, nodes[right].left);
+        update(right);
+        return right;
+    }
+}
+
+void FreeBlockTree::split(int node, int key, int& left, int& right) {
+    if (node == -1) {
+        left = right = -1;
+        return;
+    }
+
+    if (nodes[node].start < key) {
+        split(nodes[node].right, key, nodes[node].right, right);
+        left = node;
+    }
+    else {
+        split(nodes[node].left, key, left, nodes[node].left);
+        right = node;
+    }
+    update(node);
+}
+
+void FreeBlockTree::insert(int start, int size) {
+    int left, right;
+    split(root, start, left, right);
+    root = merge(merge(left, newNode(start, size)), right);
+}
+
+void FreeBlockTree::erase(int start) {
+    int left, middle, right;
+    split(root, start, left, right);
+    split(right, start + 1, middle, right);
+
+    if (middle != -1) {
+        freeNodes.push_back(middle); // a block start is unique, so middle is a single node
+    }
+    root = merge(left, right);
+}
+
+void FreeBlockTree::clear() {
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+}
+
+int FreeBlockTree::findFirstFit(int size) const {
+    int node = root;
+    while (node != -1 && nodes[node].maxSize >= size) {
+        const Node& n = nodes[node];
+
+        // go as far left (lowest address) as a fitting block exists
+        if (n.left != -1 && nodes[n.left].maxSize >= size) {
+            node = n.left;
+        }
+        else if (n.size >= size) {
+            return n.start;
+        }
+        else {
+            node = n.right;
+        }
+    }
+    return -1;
+}
+
+int FreeBlockTree::findFirstFitFrom(int minStart, int size) const {
+    return findFirstFitFrom(root, minStart, size);
+}
+
+int FreeBlockTree::findFirstFitFrom(int node, int minStart, int size) const {
+    if (node == -1 || nodes[node].maxSize < size) {
+        return -1;
+    }
+
+    const Node& n = nodes[node];
+    if (n.start < minStart) {
+        return findFirstFitFrom(n.right, minStart, size); // whole left subtree is before minStart
+    }
+
+    int found = findFirstFitFrom(n.left, minStart, size);
+    if (found != -1) {
+        return found;
+    }
+    if (n.size >= size) {
+        return n.start;
+    }
+    return findFirstFitFrom(n.right, minStart, size);
+}
+
+int FreeBlockTree::getLargestSize() const {
+    return root == -1 ? 0 : nodes[root].maxSize;
+}
+
+bool FreeBlockTree::isEmpty() const {
+    return root == -1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+// Address-ordered tree of free blocks (for flat alloc)
+// Each node also remembers the largest free block in its subtree, so fit lookups are O(log n)
+class FreeBlockTree
+{
+public:
+	FreeBlockTree();
+
+	void insert(int start, int size);	// add a free block
+	void erase(int start);	// remove the free block starting at this address
+	void clear();
+
+	int findFirstFit(int size) const;	// lowest address free block with at least this size, -1 if none
+	int findFirstFitFrom(int minStart, int size) const;	// same, but only looks at blocks at or after minStart
+	int getLargestSize() const;	// size of the largest free block, 0 if empty
+	bool isEmpty() const;
+
+private:
+	struct Node {
+		int start;	// start address of the free block
+		int size;	// size of the free block
+		int maxSize;	// largest block size in this subtree
+		unsigned int priority;	// heap priority (treap)
+		int left;
+		int right;
+	};
+
+	std::vector<Node> nodes;	// node pool, indices are used instead of pointers
+	std::vector<int> freeNodes;	// recycled node indices
+	int root;
+	unsigned int seed;
+
+	int newNode(int start, int size);
+	unsigned int nextPriority();
+	void update(int node);
+	int merge(int left, int right);
+	void split(int node, int key, int& left, int& right); // left gets start < key, right gets start >= key
+	int findFirstFitFrom(int node, int minStart, int size) const;
+};
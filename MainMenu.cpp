@@ -3,6 +3,7 @@
 #include "MainMenu.h"
 #include "ConsoleManager.h"
 #include "styles.h"
+#include "MemoryBenchmark.h"
 
 extern ConsoleManager consoleManager;
 
@@ -98,6 +99,33 @@ void MainMenu::handleCommand(string command) {
                 }
             }
 
+            else if (command.substr(0, 9) == "screen -c")
+            {
+                string arguments = command.size() > 10 ? command.substr(10) : "";
+                trim(arguments);
+                size_t separator = arguments.find(' ');
+
+                if (separator == string::npos) { // both names are needed
+                    cout << "Usage: screen -c [Parent Process Name] [Process Name]" << endl;
+                }
+                else {
+                    string parentName = arguments.substr(0, separator);
+                    string processName = arguments.substr(separator + 1);
+                    trim(processName);
+
+                    // the clone shares the parent's memory, so the parent has to exist
+                    if (!consoleManager.getResourceManager().processExists(parentName)) {
+                        cout << "Process " << parentName << " not found." << endl;
+                    }
+                    else if (consoleManager.getResourceManager().processExists(processName)) {
+                        cout << "Process already exists or has existed. Please provide a different name." << endl;
+                    }
+                    else {
+                        consoleManager.forkProcessScreen(parentName, processName);
+                    }
+                }
+            }
+
             else if (command.substr(0,9) == "screen -r")
             {
                 if (command == "screen -r") { // if the command is empty
@@ -129,6 +157,7 @@ void MainMenu::handleCommand(string command) {
                 cout << "Usage:" << endl;
                 cout << "screen - ls " << endl;
                 cout << "screen - s[Process Name] " << endl;
+                cout << "screen - c[Parent Process Name] [Process Name]" << endl;
                 cout << "screen - r[Process Name]" << endl;
             }
 
@@ -145,6 +174,41 @@ void MainMenu::handleCommand(string command) {
                 cout << "Invalid command.Please try again." << endl;
             }
 
+        } else if (command.substr(0, 9) == "benchmark") {
+            string benchmarkName = command.size() > 10 ? command.substr(10) : "";
+            trim(benchmarkName);
+            MemoryBenchmark benchmark(&consoleManager.getConfigurationManager());
+            benchmark.run(benchmarkName);
+
+        } else if (command.substr(0, 21) == "migrate-backing-store") {
+            string textFilename = command.size() > 22 ? command.substr(22) : "";
+            trim(textFilename);
+            if (textFilename.empty()) {
+                textFilename = "backing_store.txt";
+            }
+
+            int imported = consoleManager.getResourceManager().getMemoryManager()->getBackingStore()->importTextFile(textFilename);
+            if (imported == -1) {
+                cout << "Cannot open " << textFilename << "." << endl;
+            }
+            else {
+                cout << imported << " processes imported from " << textFilename << " into the binary backing store." << endl;
+            }
+
+        } else if (command.substr(0, 10) == "checkpoint" || command.substr(0, 7) == "restore") {
+            bool isCheckpoint = command.substr(0, 10) == "checkpoint";
+            string filename = command.substr(isCheckpoint ? 10 : 7);
+            trim(filename);
+            if (filename.empty()) {
+                cout << "Usage: " << (isCheckpoint ? "checkpoint" : "restore") << " [file]" << endl;
+            }
+            else if (isCheckpoint) {
+                consoleManager.getResourceManager().checkpoint(filename);
+            }
+            else {
+                consoleManager.getResourceManager().restore(filename);
+            }
+
         } else if (command == "report-util") {
             consoleManager.getResourceManager().saveReport();
 
@@ -153,9 +217,14 @@ void MainMenu::handleCommand(string command) {
 			cout << "clear/cls - Clear the screen" << endl;
 			cout << "screen -ls - List all screens" << endl;
 			cout << "screen -s [processName] - Create a new process screen" << endl;
+			cout << "screen -c [parentName] [processName] - Clone a process, its pages are shared until written" << endl;
 			cout << "scheduler-test - Start the scheduler test" << endl;
 			cout << "scheduler-stop - Stop the scheduler test" << endl;
 			cout << "report-util - Save the report" << endl;
+			cout << "benchmark [alloc|paging|pagetable|parallel|hugepage|backingstore|swapio] - Benchmark the memory allocators and the backing store" << endl;
+			cout << "migrate-backing-store [file] - Import a text backing store (default backing_store.txt) into the binary one" << endl;
+			cout << "checkpoint [file] - Save the processes, scheduler queues, core assignments and memory to a file" << endl;
+			cout << "restore [file] - Resume from a checkpoint, right after initialize with the same configuration" << endl;
 			cout << "exit - Exit the program" << endl;
 		}
 		else if (command == "process-smi") {
@@ -0,0 +1,243 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <utility>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : view(nullptr), viewSize(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile() : view(nullptr), viewSize(0), fileDescriptor(-1) {}
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& newPath, size_t minSize) {
+    close();
+    path = newPath;
+
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(fileSize.QuadPart);
+    if (!map(size < minSize ? minSize : size)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::map(size_t size) {
+    // the mapping extends the file to its size
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+    if (!mappingHandle) {
+        return false;
+    }
+
+    view = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (!view) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+        return false;
+    }
+    viewSize = size;
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (view) {
+        UnmapViewOfFile(view);
+        view = nullptr;
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    viewSize = 0;
+}
+
+bool MappedFile::resize(size_t newSize) {
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    unmap();
+
+    // a file can only shrink while nothing maps it
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!SetFilePointerEx(fileHandle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) {
+        return false;
+    }
+    return map(newSize);
+}
+
+void MappedFile::flush() {
+    if (view) {
+        FlushViewOfFile(view, 0);
+    }
+}
+
+void MappedFile::flush(size_t offset, size_t length) {
+    if (view && offset < viewSize) {
+        FlushViewOfFile(view + offset, offset + length < viewSize ? length : viewSize - offset);
+    }
+}
+
+void MappedFile::close() {
+    flush();
+    unmap();
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool MappedFile::isOpen() const {
+    return view != nullptr;
+}
+
+bool MappedFile::replaceFile(MappedFile& target) {
+    // An open file cannot be replaced here, both are closed for the move and the new one is mapped again
+    std::string targetPath = target.path;
+    size_t size = viewSize;
+    close();
+    target.close();
+    if (!MoveFileExA(path.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        target.open(targetPath, 0);
+        return false;
+    }
+    return target.open(targetPath, size);
+}
+
+#else
+
+bool MappedFile::open(const std::string& newPath, size_t minSize) {
+    close();
+    path = newPath;
+
+    fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fileDescriptor == -1) {
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0) {
+        close();
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(fileStatus.st_size);
+    if (size < minSize) {
+        if (ftruncate(fileDescriptor, static_cast<off_t>(minSize)) != 0) {
+            close();
+            return false;
+        }
+        size = minSize;
+    }
+
+    if (!map(size)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::map(size_t size) {
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    view = static_cast<char*>(address);
+    viewSize = size;
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (view) {
+        munmap(view, viewSize);
+        view = nullptr;
+    }
+    viewSize = 0;
+}
+
+bool MappedFile::resize(size_t newSize) {
+    if (fileDescriptor == -1) {
+        return false;
+    }
+
+    unmap();
+    if (ftruncate(fileDescriptor, static_cast<off_t>(newSize)) != 0) {
+        return false;
+    }
+    return map(newSize);
+}
+
+void MappedFile::flush() {
+    if (view) {
+        msync(view, viewSize, MS_ASYNC);
+    }
+}
+
+void MappedFile::flush(size_t offset, size_t length) {
+    if (!view || offset >= viewSize) {
+        return;
+    }
+
+    // msync wants a page-aligned start
+    size_t alignedOffset = offset - offset % static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = offset + length < viewSize ? offset + length : viewSize;
+    msync(view + alignedOffset, end - alignedOffset, MS_ASYNC);
+}
+
+void MappedFile::close() {
+    flush();
+    unmap();
+    if (fileDescriptor != -1) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+}
+
+bool MappedFile::isOpen() const {
+    return view != nullptr;
+}
+
+bool MappedFile::replaceFile(MappedFile& target) {
+    // rename is atomic and both stay mapped, the replaced file is only freed once this object closes it
+    if (::rename(path.c_str(), target.path.c_str()) != 0) {
+        return false;
+    }
+    std::swap(view, target.view);
+    std::swap(viewSize, target.viewSize);
+    std::swap(fileDescriptor, target.fileDescriptor);
+    return true;
+}
+
+#endif
+
+char* MappedFile::data() const {
+    return view;
+}
+
+size_t MappedFile::size() const {
+    return viewSize;
+}
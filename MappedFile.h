@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Read-write memory mapping of a whole file (for the backing store)
+// Uses file mappings on Windows and mmap elsewhere; stores go to the page cache and are written back by the OS
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(const std::string& path, size_t minSize); // creates the file if needed and maps at least minSize bytes
+	bool resize(size_t newSize); // grows or shrinks the file and maps it again, data() may move
+	void flush(); // starts writing dirty pages back without unmapping
+	void flush(size_t offset, size_t length); // same for one range of the file
+	void close();
+
+	bool isOpen() const;
+	char* data() const;
+	size_t size() const;
+
+	bool replaceFile(MappedFile& target); // renames this file over the target's in one step, the target then maps it; false leaves both as they were
+
+private:
+	std::string path;
+	char* view;
+	size_t viewSize;
+
+#ifdef _WIN32
+	HANDLE fileHandle;
+	HANDLE mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+
+	bool map(size_t size);
+	void unmap();
+};
@@ -0,0 +1,585 @@
+#include "MemoryBenchmark.h"
+#include "FlatAllocator.h"
+#include "BuddyAllocator.h"
+#include "PagingAllocator.h"
+#include "PageTable.h"
+#include "ShardedFlatAllocator.h"
+#include "TLB.h"
+#include "BackingStore.h"
+#include "SwapIOEngine.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstdio>
+
+namespace {
+    const int ALLOCATOR_OPERATIONS = 200000;
+    const int PAGING_MIN_FRAMES = 1 << 10;
+    const int PAGING_MAX_FRAMES = 1 << 24;
+    const int PAGING_PAGES_PER_PROCESS = 64;
+    const int PAGE_TABLE_FRAME_SIZE = 4; // KB
+    const long long PAGE_TABLE_MIN_MEMORY = 1LL << 20; // 1 GB in KB
+    const long long PAGE_TABLE_MAX_MEMORY = 1LL << 24; // 16 GB in KB
+    const int PAGE_TABLE_PAGES_PER_PROCESS = 1 << 14; // 64 MB processes
+    const int PAGE_TABLE_LOOKUPS = 1 << 20;
+    const int PARALLEL_MAX_THREADS = 8;
+    const int PARALLEL_OPERATIONS_PER_THREAD = 50000;
+    const int PARALLEL_LIVE_PROCESSES_PER_THREAD = 32;
+    const int PARALLEL_PAGES_PER_PROCESS = 16;
+    const int HUGE_PAGE_MAX_FRAMES = 512; // 2 MB pages out of 4 KB frames
+    const int HUGE_PAGE_TOUCHED_PAGES = 1 << 20; // base pages faulted in per page size, spread over as many processes as needed
+    const int HUGE_PAGE_TLB_ENTRIES = 64; // used if tlb-entries is 0
+    const int HUGE_PAGE_TLB_LOOKUPS = 1 << 20;
+    const int BACKING_STORE_MIN_RECORDS = 1000;
+    const int BACKING_STORE_MAX_RECORDS = 1000000;
+    const long long BACKING_STORE_TEXT_SCAN_LINES = 2000000; // lines the text loads may rescan per size, each load rereads the file
+    const char* BACKING_STORE_BENCHMARK_FILE = "benchmark_backing_store.bin";
+    const char* BACKING_STORE_BENCHMARK_TEXT_FILE = "benchmark_backing_store.txt";
+    const int BACKING_STORE_CHURN_ROUNDS = 4; // dead records per live one before the compaction
+    const int SWAP_IO_FRAMES = 4096;
+    const int SWAP_IO_FRAME_SIZE = 4; // KB
+    const int SWAP_IO_PAGES_PER_PROCESS = 64;
+    const int SWAP_IO_MAX_THREADS = 4;
+    const char* SWAP_IO_BENCHMARK_SWAP_FILE = "benchmark_swap.bin";
+
+    unsigned int nextRandom(unsigned int& seed) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    struct AllocatorResult {
+        double allocationsPerSecond;
+        double successRate;
+        double fragmentation;
+    };
+
+    // Same workload for every allocator: each step may free a random live process, then allocates a new one
+    template <typename Allocator, typename Fragmentation>
+    AllocatorResult runWorkload(Allocator& allocator, const std::vector<int>& sizes, const std::vector<unsigned int>& choices, Fragmentation fragmentation) {
+        std::vector<int> livePIDs;
+        int attempts = 0;
+        int successes = 0;
+        double fragmentationTotal = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (!livePIDs.empty() && choices[i] % 2 == 0) {
+                size_t index = choices[i] % livePIDs.size();
+                allocator.deallocate(livePIDs[index]);
+                livePIDs[index] = livePIDs.back();
+                livePIDs.pop_back();
+            }
+
+            int pid = static_cast<int>(i) + 1;
+            ++attempts;
+            if (allocator.allocate(Process("bench", pid, 1, static_cast<float>(sizes[i]), 1))) {
+                livePIDs.push_back(pid);
+                ++successes;
+            }
+            fragmentationTotal += fragmentation(allocator);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        return { seconds > 0 ? attempts / seconds : 0, successes * 100.0 / attempts, fragmentationTotal / sizes.size() };
+    }
+
+    // Admit a process and fault in every one of its pages
+    void touchAllPages(PagingAllocator& pagingAllocator, int pid) {
+        pagingAllocator.allocate(Process("bench", pid, 1, PAGING_PAGES_PER_PROCESS, 1));
+        for (int page = 0; page < PAGING_PAGES_PER_PROCESS; ++page) {
+            pagingAllocator.accessPage(pid, page, false, 0);
+        }
+    }
+
+    // Runs work(thread) on every thread at once, returns the seconds until all of them finished
+    template <typename Work>
+    double runThreads(int numThreads, Work work) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back(work, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void printResult(const std::string& name, const AllocatorResult& result, const std::string& fragmentationType) {
+        std::cout << std::left << std::setw(16) << name
+            << std::right << std::setw(14) << static_cast<long long>(result.allocationsPerSecond) << " allocs/s"
+            << std::setw(10) << std::fixed << std::setprecision(2) << result.successRate << "% fit"
+            << std::setw(10) << result.fragmentation << "% " << fragmentationType << "\n" << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+MemoryBenchmark::MemoryBenchmark(ConfigurationManager* configManager) : configManager(configManager) {}
+
+void MemoryBenchmark::run(const std::string& name) {
+    if (name == "alloc") {
+        runAllocatorBenchmark();
+    }
+    else if (name == "paging") {
+        runPagingBenchmark();
+    }
+    else if (name == "pagetable") {
+        runPageTableBenchmark();
+    }
+    else if (name == "parallel") {
+        runParallelBenchmark();
+    }
+    else if (name == "hugepage") {
+        runHugePageBenchmark();
+    }
+    else if (name == "backingstore") {
+        runBackingStoreBenchmark();
+    }
+    else if (name == "swapio") {
+        runSwapIOBenchmark();
+    }
+    else {
+        std::cout << "Usage: benchmark [alloc|paging|pagetable|parallel|hugepage|backingstore|swapio]" << std::endl;
+    }
+}
+
+int MemoryBenchmark::getRandomProcessSize(unsigned int& seed) const {
+    int minExp = static_cast<int>(std::ceil(std::log2(std::max(1.0f, configManager->getMinMemoryPerProcess()))));
+    int maxExp = static_cast<int>(std::floor(std::log2(std::max(1.0f, configManager->getMaxMemoryPerProcess()))));
+    if (maxExp < minExp) {
+        maxExp = minExp;
+    }
+    return 1 << (minExp + static_cast<int>(nextRandom(seed) % (maxExp - minExp + 1)));
+}
+
+void MemoryBenchmark::runAllocatorBenchmark() {
+    // Generate the workload once so every allocator sees the same requests
+    unsigned int seed = 2463534242u;
+    std::vector<int> sizes(ALLOCATOR_OPERATIONS);
+    std::vector<unsigned int> choices(ALLOCATOR_OPERATIONS);
+    for (int i = 0; i < ALLOCATOR_OPERATIONS; ++i) {
+        sizes[i] = getRandomProcessSize(seed);
+        choices[i] = nextRandom(seed);
+    }
+
+    std::cout << "Allocator benchmark: " << ALLOCATOR_OPERATIONS << " allocations, "
+        << configManager->getMaxOverallMemory() << " KB memory, "
+        << configManager->getMinMemoryPerProcess() << "-" << configManager->getMaxMemoryPerProcess() << " KB per process\n";
+
+    const std::string policies[] = { "first", "best", "next" };
+    for (const auto& policy : policies) {
+        ConfigurationManager flatConfig = *configManager;
+        flatConfig.setFlatFitPolicy(policy);
+
+        FlatAllocator flatAllocator;
+        flatAllocator.initialize(&flatConfig);
+        AllocatorResult result = runWorkload(flatAllocator, sizes, choices, [](FlatAllocator& allocator) {
+            return allocator.getExternalFragmentation();
+            });
+        printResult("flat (" + policy + ")", result, "external frag");
+    }
+
+    BuddyAllocator buddyAllocator;
+    buddyAllocator.initialize(configManager);
+    AllocatorResult result = runWorkload(buddyAllocator, sizes, choices, [](BuddyAllocator& allocator) {
+        return allocator.getInternalFragmentation();
+        });
+    printResult("buddy", result, "internal frag");
+}
+
+void MemoryBenchmark::runPagingBenchmark() {
+    std::cout << "Paging benchmark: " << PAGING_PAGES_PER_PROCESS << " pages per process\n";
+    std::cout << std::left << std::setw(12) << "frames"
+        << std::right << std::setw(20) << "fill pages/s"
+        << std::setw(20) << "evict pages/s" << "\n";
+
+    for (int numFrames = PAGING_MIN_FRAMES; numFrames <= PAGING_MAX_FRAMES; numFrames *= 4) {
+        // 1 KB frames so memory size equals the number of frames
+        ConfigurationManager pagingConfig = *configManager;
+        pagingConfig.setMemoryPerFrame(1);
+        pagingConfig.setMaxOverallMemory(static_cast<float>(numFrames));
+        pagingConfig.setSwapSize(0); // default swap area, four times the memory
+
+        PagingAllocator pagingAllocator;
+        pagingAllocator.initialize(&pagingConfig);
+
+        // Fill every frame, every page comes from the free frames
+        int numProcesses = numFrames / PAGING_PAGES_PER_PROCESS;
+        int pid = 1;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numProcesses; ++i, ++pid) {
+            touchAllPages(pagingAllocator, pid);
+        }
+        double fillSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Allocate a quarter of memory again, every page needs an eviction first
+        int numEvictingProcesses = std::max(1, numProcesses / 4);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numEvictingProcesses; ++i, ++pid) {
+            touchAllPages(pagingAllocator, pid);
+        }
+        double evictSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long fillPages = static_cast<long long>(numProcesses) * PAGING_PAGES_PER_PROCESS;
+        long long evictPages = static_cast<long long>(numEvictingProcesses) * PAGING_PAGES_PER_PROCESS;
+        std::cout << std::left << std::setw(12) << numFrames
+            << std::right << std::setw(20) << static_cast<long long>(fillSeconds > 0 ? fillPages / fillSeconds : 0)
+            << std::setw(20) << static_cast<long long>(evictSeconds > 0 ? evictPages / evictSeconds : 0) << "\n";
+    }
+}
+
+void MemoryBenchmark::runPageTableBenchmark() {
+    std::cout << "Page table benchmark: " << PAGE_TABLE_FRAME_SIZE << " KB frames, "
+        << PAGE_TABLE_PAGES_PER_PROCESS * PAGE_TABLE_FRAME_SIZE / 1024 << " MB processes, "
+        << "virtual memory twice the physical memory, half of every process resident\n";
+    std::cout << std::left << std::setw(10) << "memory" << std::setw(10) << "table"
+        << std::right << std::setw(16) << "host KB" << std::setw(16) << "maps/s"
+        << std::setw(16) << "ns/lookup" << std::setw(18) << "accesses/lookup" << "\n";
+
+    for (long long memory = PAGE_TABLE_MIN_MEMORY; memory <= PAGE_TABLE_MAX_MEMORY; memory *= 4) {
+        int numFrames = static_cast<int>(memory / PAGE_TABLE_FRAME_SIZE);
+        int numProcesses = 2 * numFrames / PAGE_TABLE_PAGES_PER_PROCESS;
+        int residentPages = PAGE_TABLE_PAGES_PER_PROCESS / 2;
+
+        for (const auto& name : PageTable::getPageTableNames()) {
+            std::unique_ptr<PageTable> pageTable = PageTable::create(name);
+            pageTable->initialize(numFrames);
+
+            // Every process touches the first half of its pages, which fills memory exactly
+            int frame = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int pid = 1; pid <= numProcesses; ++pid) {
+                pageTable->addProcess(pid, PAGE_TABLE_PAGES_PER_PROCESS);
+                for (int page = 0; page < residentPages; ++page) {
+                    pageTable->map(pid, page, frame++);
+                }
+            }
+            double mapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            // Random lookups of resident pages
+            unsigned int seed = 2463534242u;
+            int misses = 0;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < PAGE_TABLE_LOOKUPS; ++i) {
+                int pid = 1 + static_cast<int>(nextRandom(seed) % numProcesses);
+                int page = static_cast<int>(nextRandom(seed) % residentPages);
+                if (pageTable->lookup(pid, page).frame == -1) {
+                    ++misses;
+                }
+            }
+            double lookupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << std::left << std::setw(10) << (std::to_string(memory >> 20) + " GB") << std::setw(10) << name
+                << std::right << std::setw(16) << pageTable->getFootprint() / 1024
+                << std::setw(16) << static_cast<long long>(mapSeconds > 0 ? frame / mapSeconds : 0)
+                << std::fixed << std::setprecision(1) << std::setw(16) << lookupSeconds * 1e9 / PAGE_TABLE_LOOKUPS
+                << std::setprecision(2) << std::setw(18) << pageTable->getAverageLookupSteps()
+                << std::defaultfloat << std::setprecision(6) << (misses ? " (lookup misses)" : "") << "\n";
+        }
+    }
+}
+
+void MemoryBenchmark::runParallelBenchmark() {
+    // Every thread keeps a bounded set of live processes so memory never runs out
+    int maxProcessSize = 1 << static_cast<int>(std::floor(std::log2(std::max(1.0f, configManager->getMaxMemoryPerProcess()))));
+    int flatMemory = 2 * PARALLEL_MAX_THREADS * PARALLEL_LIVE_PROCESSES_PER_THREAD * maxProcessSize;
+    int pagingFrames = PARALLEL_MAX_THREADS * PARALLEL_LIVE_PROCESSES_PER_THREAD * PARALLEL_PAGES_PER_PROCESS;
+
+    std::cout << "Parallel benchmark: " << PARALLEL_OPERATIONS_PER_THREAD << " allocations per thread, "
+        << flatMemory << " KB flat memory, " << pagingFrames << " frames\n";
+    std::cout << std::left << std::setw(10) << "threads"
+        << std::right << std::setw(20) << "flat 1 arena/s" << std::setw(22) << "flat sharded/s"
+        << std::setw(20) << "paging procs/s" << "\n";
+
+    for (int numThreads = 1; numThreads <= PARALLEL_MAX_THREADS; numThreads *= 2) {
+        // Same flat workload with one shared arena and with a local arena per thread
+        double flatResults[2];
+        const int shardCounts[2] = { 1, numThreads + 1 };
+        for (int i = 0; i < 2; ++i) {
+            ConfigurationManager flatConfig = *configManager;
+            flatConfig.setMaxOverallMemory(static_cast<float>(flatMemory));
+            flatConfig.setMemoryShards(shardCounts[i]);
+
+            ShardedFlatAllocator flatAllocator;
+            flatAllocator.initialize(&flatConfig);
+            double seconds = runThreads(numThreads, [this, &flatAllocator, numThreads](int thread) {
+                unsigned int seed = 2463534242u + thread;
+                std::vector<int> livePIDs;
+                for (int op = 0; op < PARALLEL_OPERATIONS_PER_THREAD; ++op) {
+                    if (static_cast<int>(livePIDs.size()) == PARALLEL_LIVE_PROCESSES_PER_THREAD || (!livePIDs.empty() && nextRandom(seed) % 2 == 0)) {
+                        size_t index = nextRandom(seed) % livePIDs.size();
+                        flatAllocator.deallocate(livePIDs[index]);
+                        livePIDs[index] = livePIDs.back();
+                        livePIDs.pop_back();
+                    }
+
+                    int pid = 1 + thread + op * numThreads; // pid % threads == thread, so each thread has its own arena
+                    if (flatAllocator.allocate(Process("bench", pid, 1, static_cast<float>(getRandomProcessSize(seed)), 1))) {
+                        livePIDs.push_back(pid);
+                    }
+                }
+                });
+            flatResults[i] = numThreads * PARALLEL_OPERATIONS_PER_THREAD / seconds;
+        }
+
+        // Paging: admit a process, fault in all of its pages, free it
+        ConfigurationManager pagingConfig = *configManager;
+        pagingConfig.setMemoryPerFrame(1);
+        pagingConfig.setMaxOverallMemory(static_cast<float>(pagingFrames));
+        pagingConfig.setSwapSize(0);
+        PagingAllocator pagingAllocator;
+        pagingAllocator.initialize(&pagingConfig);
+        int pagingOperations = PARALLEL_OPERATIONS_PER_THREAD / PARALLEL_PAGES_PER_PROCESS;
+        double pagingSeconds = runThreads(numThreads, [&pagingAllocator, numThreads, pagingOperations](int thread) {
+            for (int op = 0; op < pagingOperations; ++op) {
+                int pid = 1 + thread + op * numThreads;
+                pagingAllocator.allocate(Process("bench", pid, 1, PARALLEL_PAGES_PER_PROCESS, 1));
+                for (int page = 0; page < PARALLEL_PAGES_PER_PROCESS; ++page) {
+                    pagingAllocator.accessPage(pid, page, false, 0);
+                }
+                pagingAllocator.deallocate(pid);
+            }
+            });
+
+        std::cout << std::left << std::setw(10) << numThreads << std::right
+            << std::setw(20) << static_cast<long long>(flatResults[0])
+            << std::setw(22) << static_cast<long long>(flatResults[1])
+            << std::setw(20) << static_cast<long long>(numThreads * pagingOperations / pagingSeconds) << "\n";
+    }
+}
+
+void MemoryBenchmark::runHugePageBenchmark() {
+    int frameSize = std::max(1, static_cast<int>(configManager->getMemoryPerFrame()));
+    int processSize = std::max(frameSize, static_cast<int>(configManager->getMaxMemoryPerProcess()));
+    int numPages = processSize / frameSize;
+    int numProcesses = std::max(1, HUGE_PAGE_TOUCHED_PAGES / numPages);
+    int tlbEntries = configManager->getTLBEntries() > 0 ? configManager->getTLBEntries() : HUGE_PAGE_TLB_ENTRIES;
+
+    std::cout << "Huge page benchmark: " << numProcesses << " processes of " << processSize << " KB (" << numPages << " pages of "
+        << frameSize << " KB), every page touched once, " << tlbEntries << "-entry TLB with random references\n";
+    std::cout << std::left << std::setw(12) << "page KB"
+        << std::right << std::setw(14) << "faults/proc" << std::setw(14) << "us/proc" << std::setw(12) << "mappings"
+        << std::setw(16) << "TLB reach KB" << std::setw(14) << "TLB hits" << "\n";
+
+    // Base pages first, then huge pages of 8, 64 and 512 frames that still fit in the process
+    for (int hugePageFrames = 1; hugePageFrames <= std::min(numPages, HUGE_PAGE_MAX_FRAMES); hugePageFrames *= 8) {
+        ConfigurationManager pagingConfig = *configManager;
+        pagingConfig.setMaxOverallMemory(static_cast<float>(2 * numPages * frameSize)); // room for an aligned run wherever the process is
+        pagingConfig.setHugePageSize(hugePageFrames > 1 ? static_cast<float>(hugePageFrames * frameSize) : 0);
+        PagingAllocator pagingAllocator;
+        pagingAllocator.initialize(&pagingConfig);
+
+        float pageSize = static_cast<float>(hugePageFrames * frameSize); // the process asks for this page size
+        int mappings = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int pid = 1; pid <= numProcesses; ++pid) {
+            pagingAllocator.allocate(Process("bench", pid, 1, static_cast<float>(processSize), pageSize));
+            for (int page = 0; page < numPages; ++page) {
+                pagingAllocator.accessPage(pid, page * frameSize, false, 0);
+            }
+            mappings = pagingAllocator.getNumPageTableMappings();
+            pagingAllocator.deallocate(pid);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // A TLB entry covers a whole page, so random references over the process hit more often with larger pages
+        TLB tlb;
+        tlb.configure(tlbEntries, configManager->getTLBWays(), true);
+        unsigned int seed = 2463534242u;
+        int node = 0;
+        for (int i = 0; i < HUGE_PAGE_TLB_LOOKUPS; ++i) {
+            int page = static_cast<int>(nextRandom(seed) % numPages) / hugePageFrames;
+            if (!tlb.lookup(1, page, false, node)) {
+                tlb.insert(1, page, false, 0, tlb.getGeneration(1, page));
+            }
+        }
+
+        std::cout << std::left << std::setw(12) << hugePageFrames * frameSize << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << static_cast<double>(pagingAllocator.getNumPageFaults()) / numProcesses
+            << std::setw(14) << seconds * 1e6 / numProcesses << std::setw(12) << mappings
+            << std::setw(16) << static_cast<long long>(tlbEntries) * hugePageFrames * frameSize
+            << std::setprecision(2) << std::setw(13) << tlb.getNumHits() * 100.0 / HUGE_PAGE_TLB_LOOKUPS << "%"
+            << "\n" << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+void MemoryBenchmark::runBackingStoreBenchmark() {
+    std::cout << "Backing store benchmark: store every process once, then load random ones\n";
+    std::cout << std::left << std::setw(12) << "processes"
+        << std::right << std::setw(16) << "bin stores/s" << std::setw(16) << "bin loads/s"
+        << std::setw(16) << "text stores/s" << std::setw(16) << "text loads/s" << "\n";
+
+    for (int numRecords = BACKING_STORE_MIN_RECORDS; numRecords <= BACKING_STORE_MAX_RECORDS; numRecords *= 10) {
+        std::vector<std::shared_ptr<Process>> processes;
+        for (int pid = 1; pid <= numRecords; ++pid) {
+            processes.push_back(std::make_shared<Process>("process" + std::to_string(pid), pid, 1000, 256.0f, 16.0f));
+        }
+
+        // Binary store, appends into the mapped file and one index probe per load
+        std::remove(BACKING_STORE_BENCHMARK_FILE);
+        double binaryStoreSeconds;
+        double binaryLoadSeconds;
+        {
+            BackingStore backingStore(BACKING_STORE_BENCHMARK_FILE);
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& process : processes) {
+                backingStore.storeProcess(process);
+            }
+            binaryStoreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            unsigned int seed = 2463534242u;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < numRecords; ++i) {
+                backingStore.loadProcess(static_cast<int>(nextRandom(seed) % numRecords) + 1);
+            }
+            binaryLoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        std::remove(BACKING_STORE_BENCHMARK_FILE);
+
+        // The old format, one flushed line per store and a rescan from the start per load
+        std::remove(BACKING_STORE_BENCHMARK_TEXT_FILE);
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::ofstream textFile(BACKING_STORE_BENCHMARK_TEXT_FILE, std::ios::out | std::ios::app);
+            for (const auto& process : processes) {
+                textFile << process->getID() << " " << process->getName() << " "
+                    << process->getTotalInstructions() << " " << process->getMemorySize() << std::endl;
+            }
+        }
+        double textStoreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        int textLoads = static_cast<int>(std::max(1LL, BACKING_STORE_TEXT_SCAN_LINES / numRecords));
+        unsigned int seed = 2463534242u;
+        start = std::chrono::steady_clock::now();
+        {
+            std::ifstream textFile(BACKING_STORE_BENCHMARK_TEXT_FILE);
+            for (int i = 0; i < textLoads; ++i) {
+                int pid = static_cast<int>(nextRandom(seed) % numRecords) + 1;
+                textFile.clear();
+                textFile.seekg(0, std::ios::beg);
+                int id;
+                std::string name;
+                float totalInstructions, memorySize;
+                while (textFile >> id >> name >> totalInstructions >> memorySize && id != pid) {
+                }
+            }
+        }
+        double textLoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::remove(BACKING_STORE_BENCHMARK_TEXT_FILE);
+
+        std::cout << std::left << std::setw(12) << numRecords << std::right
+            << std::setw(16) << static_cast<long long>(binaryStoreSeconds > 0 ? numRecords / binaryStoreSeconds : 0)
+            << std::setw(16) << static_cast<long long>(binaryLoadSeconds > 0 ? numRecords / binaryLoadSeconds : 0)
+            << std::setw(16) << static_cast<long long>(textStoreSeconds > 0 ? numRecords / textStoreSeconds : 0)
+            << std::setw(16) << static_cast<long long>(textLoadSeconds > 0 ? textLoads / textLoadSeconds : 0) << "\n";
+    }
+
+    // Compaction while the store keeps being written, removes and stores go on from another thread throughout
+    std::cout << "\nCompaction: every process removed and stored again " << BACKING_STORE_CHURN_ROUNDS << " times, then compacted under churn\n";
+    std::cout << std::left << std::setw(12) << "processes"
+        << std::right << std::setw(14) << "amp before" << std::setw(14) << "amp after" << std::setw(14) << "compact ms"
+        << std::setw(14) << "pause us" << std::setw(18) << "max store us" << "\n";
+
+    for (int numRecords = BACKING_STORE_MIN_RECORDS; numRecords <= BACKING_STORE_MAX_RECORDS / 10; numRecords *= 10) {
+        std::remove(BACKING_STORE_BENCHMARK_FILE);
+        BackingStore backingStore(BACKING_STORE_BENCHMARK_FILE);
+        for (int pid = 1; pid <= numRecords; ++pid) {
+            backingStore.storeProcess(std::make_shared<Process>("process" + std::to_string(pid), pid, 1000, 256.0f, 16.0f));
+        }
+        for (int round = 0; round < BACKING_STORE_CHURN_ROUNDS; ++round) {
+            for (int pid = 1; pid <= numRecords; ++pid) {
+                backingStore.removeProcess(pid);
+                backingStore.storeProcess(std::make_shared<Process>("process" + std::to_string(pid), pid, 1000, 256.0f, 16.0f));
+            }
+        }
+        double ampBefore = backingStore.getSpaceAmplification();
+
+        std::atomic<bool> compacting(true);
+        long long maxStoreMicros = 0;
+        std::thread writer([&backingStore, &compacting, &maxStoreMicros, numRecords]() {
+            unsigned int seed = 2463534242u;
+            while (compacting) {
+                int pid = static_cast<int>(nextRandom(seed) % numRecords) + 1;
+                auto start = std::chrono::steady_clock::now();
+                backingStore.storeProcess(std::make_shared<Process>("process" + std::to_string(pid), pid, 1000, 256.0f, 16.0f));
+                maxStoreMicros = std::max(maxStoreMicros, static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+            }
+            });
+        backingStore.compact();
+        compacting = false;
+        writer.join();
+
+        std::cout << std::left << std::setw(12) << numRecords << std::right << std::fixed << std::setprecision(2)
+            << std::setw(14) << ampBefore << std::setw(14) << backingStore.getSpaceAmplification()
+            << std::setw(14) << backingStore.getLastCompactionTime() / 1000.0 << std::defaultfloat << std::setprecision(6)
+            << std::setw(14) << backingStore.getLastCompactionPause() << std::setw(18) << maxStoreMicros << "\n";
+    }
+    std::remove(BACKING_STORE_BENCHMARK_FILE);
+}
+
+void MemoryBenchmark::runSwapIOBenchmark() {
+    std::cout << "Swap I/O benchmark: " << SWAP_IO_FRAMES << " frames of " << SWAP_IO_FRAME_SIZE << " KB, processes touch four times as many pages\n";
+    std::cout << std::left << std::setw(12) << "io threads"
+        << std::right << std::setw(16) << "evictions/s" << std::setw(16) << "written/s"
+        << std::setw(14) << "pages/run" << std::setw(12) << "max depth" << "\n";
+
+    for (int numThreads = 0; numThreads <= SWAP_IO_MAX_THREADS; numThreads = numThreads ? numThreads * 2 : 1) {
+        ConfigurationManager pagingConfig = *configManager;
+        pagingConfig.setMemoryPerFrame(SWAP_IO_FRAME_SIZE);
+        pagingConfig.setMaxOverallMemory(static_cast<float>(SWAP_IO_FRAMES * SWAP_IO_FRAME_SIZE));
+        pagingConfig.setSwapSize(0);
+        pagingConfig.setHugePageSize(0);
+
+        std::remove(BACKING_STORE_BENCHMARK_FILE);
+        std::remove(SWAP_IO_BENCHMARK_SWAP_FILE);
+        double evictSeconds;
+        double totalSeconds;
+        long long pagesWritten;
+        long long writeRuns;
+        int maxDepth;
+        {
+            BackingStore backingStore(BACKING_STORE_BENCHMARK_FILE);
+            SwapIOEngine swapIO(backingStore);
+            PagingAllocator pagingAllocator;
+            pagingAllocator.initialize(&pagingConfig);
+            backingStore.configureSwap(SWAP_IO_BENCHMARK_SWAP_FILE, pagingAllocator.getSwapSize() / SWAP_IO_FRAME_SIZE, SWAP_IO_FRAME_SIZE * 1024);
+            pagingAllocator.setSwapCallbacks([&swapIO](int slot, int pid, int pageNumber) {
+                swapIO.submitWrite(slot, pid, pageNumber);
+                }, nullptr);
+            swapIO.start(numThreads);
+
+            // Evictions only wait for the writes when there are no workers
+            int numProcesses = 4 * SWAP_IO_FRAMES / SWAP_IO_PAGES_PER_PROCESS;
+            auto start = std::chrono::steady_clock::now();
+            for (int pid = 1; pid <= numProcesses; ++pid) {
+                pagingAllocator.allocate(Process("bench", pid, 1, static_cast<float>(SWAP_IO_PAGES_PER_PROCESS * SWAP_IO_FRAME_SIZE), SWAP_IO_FRAME_SIZE));
+                for (int page = 0; page < SWAP_IO_PAGES_PER_PROCESS; ++page) {
+                    pagingAllocator.accessPage(pid, page * SWAP_IO_FRAME_SIZE, false, 0);
+                }
+            }
+            evictSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            swapIO.drain();
+            totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            pagesWritten = backingStore.getNumPageWrites();
+            writeRuns = backingStore.getNumPageWriteRuns();
+            maxDepth = swapIO.getMaxQueueDepth();
+        }
+        std::remove(BACKING_STORE_BENCHMARK_FILE);
+        std::remove(SWAP_IO_BENCHMARK_SWAP_FILE);
+
+        std::cout << std::left << std::setw(12) << numThreads << std::right
+            << std::setw(16) << static_cast<long long>(evictSeconds > 0 ? pagesWritten / evictSeconds : 0)
+            << std::setw(16) << static_cast<long long>(totalSeconds > 0 ? pagesWritten / totalSeconds : 0)
+            << std::fixed << std::setprecision(2) << std::setw(14) << (writeRuns ? static_cast<double>(pagesWritten) / writeRuns : 0)
+            << std::defaultfloat << std::setprecision(6) << std::setw(12) << maxDepth << "\n";
+    }
+}
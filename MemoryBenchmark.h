@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+#include "ConfigurationManager.h"
+
+// Runs the memory allocators outside of the scheduler to measure their throughput
+// Each benchmark uses its own allocator instances built from the current configuration
+class MemoryBenchmark
+{
+public:
+	MemoryBenchmark(ConfigurationManager* configManager);
+
+	void run(const std::string& name); // Runs a benchmark by name, prints usage if the name is unknown
+
+	void runAllocatorBenchmark(); // FlatAllocator (every fit policy) vs BuddyAllocator
+	void runPagingBenchmark(); // PagingAllocator page allocation throughput from 1k to 16M frames
+	void runPageTableBenchmark(); // Host memory and lookup cost of every page table layout from 1 GB to 16 GB
+	void runParallelBenchmark(); // Allocation throughput with 1 to 8 threads sharing one allocator
+	void runHugePageBenchmark(); // Faults, page table mappings and TLB reach of a max-mem-per-proc process for several page sizes
+	void runBackingStoreBenchmark(); // Store and load throughput of the binary backing store against the old text file, and compaction under churn
+	void runSwapIOBenchmark(); // Eviction throughput with swap writes on the evicting thread and on 1 to 4 swap I/O workers
+
+private:
+	ConfigurationManager* configManager;
+
+	int getRandomProcessSize(unsigned int& seed) const; // 2^n between min-mem-per-proc and max-mem-per-proc
+};
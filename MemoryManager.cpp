@@ -1,15 +1,25 @@
 #include <iostream>
+#include <chrono>
 #include "MemoryManager.h"
 
-MemoryManager::MemoryManager() : backingStore("backing_store.txt"), running(false) // Initialize running to false
+namespace {
+    const int COMPACTION_MOVES_PER_TICK = 4; // Blocks moved by each background compaction step
+    const double FAULT_RATE_SMOOTHING = 0.5; // weight of the newest sample in the fault rate
+    const int RECLAIM_BATCH_PAGES = 32; // pages evicted per allocator lock hold by background reclaim
+    const int HUGE_PAGE_PROMOTIONS_PER_TICK = 4; // regions collapsed into huge pages by each background step
+}
+
+MemoryManager::MemoryManager() : backingStore("backing_store.bin"), swapIO(backingStore), swapPool(swapIO), running(false), numProcessesSwappedOut(0), swappedOutMemory(0), // Initialize running to false
+    numSwapIns(0), numFailedSwapIns(0), numMemoryFrees(0),
+    thrashing(false), recentFaultRate(0), lastPageReferences(0), lastMajorFaults(0),
+    numReclaimWakeups(0), lowWatermark(0), highWatermark(0),
+    numProcessesReleased(0), numReleaseBatches(0), largestReleaseBatch(0), totalReleaseLatency(0), maxReleaseLatency(0),
+    releaseLatencyHistogram(SwapIOEngine::NUM_LATENCY_BUCKETS, 0)
 {
 }
 
 MemoryManager::~MemoryManager() {
     stop();
-    if (memoryThread.joinable()) {
-        memoryThread.join();
-    }
 }
 
 bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* scheduler) {
@@ -17,6 +27,7 @@ bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* s
         this->configManager = configManager;
         this->scheduler = scheduler;
         allocationType = configManager->getMemoryManagerAlgorithm();
+        swapIO.start(configManager->getSwapIOThreads()); // evictions only queue their writes
 
         // Initialize the memory allocator based on the configuration
         if (allocationType == "flat") {
@@ -24,6 +35,28 @@ bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* s
         }
         else if (allocationType == "paging") {
             pagingAllocator.initialize(configManager);
+            pagingAllocator.setPageEvictionCallback([scheduler](int pid, int pageNumber) {
+                scheduler->invalidateTLBEntry(pid, pageNumber);
+                });
+
+            // Evicted pages are compressed into the swap pool, the coldest ones go on to their own slot of the swap area next to the backing store
+            int pageSize = static_cast<int>(configManager->getMemoryPerFrame());
+            backingStore.configureSwap("swap.bin", pagingAllocator.getSwapSize() / pageSize, pageSize * 1024);
+            swapPool.initialize(static_cast<size_t>(configManager->getMaxOverallMemory() * std::max(0.0f, configManager->getZswapPoolPercent()) / 100 * 1024), pageSize * 1024);
+            pagingAllocator.setSwapCallbacks([this](int slot, int pid, int pageNumber) {
+                this->swapPool.storePage(slot, pid, pageNumber);
+                }, [this](int slot, int, int pageNumber) {
+                this->swapPool.loadPage(slot, pageNumber);
+                }, [this](int slot) {
+                this->swapPool.invalidate(slot);
+                });
+
+            int numFrames = pagingAllocator.getNumFrames();
+            lowWatermark = std::max(1, static_cast<int>(numFrames * configManager->getReclaimLowWatermark() / 100));
+            highWatermark = std::min(numFrames, std::max(lowWatermark + 1, static_cast<int>(numFrames * configManager->getReclaimHighWatermark() / 100)));
+        }
+        else if (allocationType == "buddy") {
+            buddyAllocator.initialize(configManager);
         }
 
         running = true;
@@ -36,17 +69,31 @@ bool MemoryManager::initialize(ConfigurationManager* configManager, Scheduler* s
     }
 }
 
-bool MemoryManager::allocate(Process process) {
+bool MemoryManager::allocate(Process process, bool swapOut) {
     if (allocationType == "flat") {
+        // The arenas lock themselves, only the compaction and swap-out slow path is serialized
         if (!flatAllocator.allocate(process)) {
+            std::lock_guard<std::mutex> lock(allocatorMutex);
+
+            // Enough memory may be free but scattered, compact before swapping anything out
+            if (flatAllocator.compactFor(static_cast<int>(process.getMemorySize()))) {
+                return flatAllocator.allocate(process);
+            }
+            if (!swapOut) {
+                return false;
+            }
+
             // If allocation fails, swap out a random process and try again
-            std::unordered_set<int> runningProcessIDs = getRunningProcessIDs();
+            std::unordered_set<int> runningProcessIDs = getUnevictableProcessIDs();
             int swappedOutProcessID = flatAllocator.swapOutRandomProcess(runningProcessIDs);
 
             if (swappedOutProcessID != -1) {
+                ++numProcessesSwappedOut;
                 auto swappedOutProcess = scheduler->getProcessByID(swappedOutProcessID);
                 if (swappedOutProcess) {
-                    backingStore.storeProcess(swappedOutProcess);
+                    swapIO.submitStore(swappedOutProcess);
+                    swappedOutProcesses[swappedOutProcessID] = static_cast<int>(swappedOutProcess->getMemorySize());
+                    swappedOutMemory += static_cast<int>(swappedOutProcess->getMemorySize());
                 }
             }
 
@@ -57,25 +104,37 @@ bool MemoryManager::allocate(Process process) {
         }
     }
     else if (allocationType == "paging") {
-        if (!pagingAllocator.allocate(process, [this](std::shared_ptr<Process> process) {
-            this->backingStore.storeProcess(process);
-            })) {
-            // If allocation fails, swap out a random page and try again
-            std::unordered_set<int> runningProcessIDs = getRunningProcessIDs();
-            int swappedOutProcessID = pagingAllocator.swapOutRandomPage(runningProcessIDs, [this](std::shared_ptr<Process> process) {
-                this->backingStore.storeProcess(process);
-                });
+        // A clone shares its parent's frames until it writes to them
+        if (process.getParentID() != -1 && pagingAllocator.fork(process.getParentID(), process)) {
+            return true;
+        }
+
+        // Pages are only loaded when the process touches them
+        return pagingAllocator.allocate(process);
+    }
+    else if (allocationType == "buddy") {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        if (!buddyAllocator.allocate(process)) {
+            if (!swapOut) {
+                return false;
+            }
+
+            // If allocation fails, swap out a random process and try again
+            std::unordered_set<int> runningProcessIDs = getUnevictableProcessIDs();
+            int swappedOutProcessID = buddyAllocator.swapOutRandomProcess(runningProcessIDs);
 
             if (swappedOutProcessID != -1) {
+                ++numProcessesSwappedOut;
                 auto swappedOutProcess = scheduler->getProcessByID(swappedOutProcessID);
                 if (swappedOutProcess) {
-                    backingStore.storeProcess(swappedOutProcess);
+                    swapIO.submitStore(swappedOutProcess);
+                    swappedOutProcesses[swappedOutProcessID] = static_cast<int>(swappedOutProcess->getMemorySize());
+                    swappedOutMemory += static_cast<int>(swappedOutProcess->getMemorySize());
                 }
             }
 
-            return pagingAllocator.allocate(process, [this](std::shared_ptr<Process> process) {
-                this->backingStore.storeProcess(process);
-                });
+            return buddyAllocator.allocate(process);
         }
         else {
             return true;
@@ -84,30 +143,421 @@ bool MemoryManager::allocate(Process process) {
     return false;
 }
 
-void MemoryManager::deallocate(int pid) {
-    if (allocationType == "flat") {
-        flatAllocator.deallocate(pid);
+MemoryAccess MemoryManager::accessMemory(std::shared_ptr<Process> process, int node) {
+    if (allocationType != "paging") {
+        return { 0, -1, false, false }; // flat and buddy processes are fully resident, there is no translation to cache
     }
-    else if (allocationType == "paging") {
-        pagingAllocator.deallocate(pid);
+
+    PageAccess access = pagingAllocator.accessPage(process->getID(), process->getNextMemoryReference(), process->isNextReferenceWrite(), node);
+    PageFaultType faultType = access.faultType;
+
+    if (faultType == PageFaultType::None) {
+        return { 0, access.node, access.mapped, access.writable };
+    }
+
+    // Nothing could be evicted, the process waits as long as for a major fault and faults on the page again at its next reference
+    if (faultType == PageFaultType::NoFrame) {
+        return { configManager->getPageFaultDelay(), -1, false, false };
+    }
+
+    if (pagingAllocator.getNumFreeFrames() < lowWatermark) {
+        reclaimWakeup.notify_one(); // refill the free frames before the next fault has to evict
+    }
+
+    // A minor fault only zero-fills or copies a frame, a major fault waits for the backing store
+    process->recordPageFault(faultType == PageFaultType::Major);
+    return { faultType == PageFaultType::Major ? configManager->getPageFaultDelay() : 0, access.node, access.mapped, access.writable };
+}
+
+void MemoryManager::recordTLBHits(std::shared_ptr<Process> process, const std::vector<int>& addresses) {
+    if (allocationType == "paging") {
+        pagingAllocator.recordTLBHits(process->getID(), addresses);
+    }
+}
+
+bool MemoryManager::swapIn(std::shared_ptr<Process> process, int node) {
+    int pid = process->getID();
+    if (isResident(pid)) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(swapInMutex);
+        if (!swappingIn.insert(pid).second) {
+            return false; // already on its way back
+        }
+    }
+
+    // The process waits off the ready queue, the time until it is resumed counts as its wait time
+    submitSwapIn(process, node, std::chrono::steady_clock::now());
+    return false;
+}
+
+void MemoryManager::submitSwapIn(std::shared_ptr<Process> process, int node, std::chrono::steady_clock::time_point start) {
+    swapIO.submitSwapIn([this, process, node, start]() {
+        long long freesBefore;
+        {
+            std::lock_guard<std::mutex> lock(swapInMutex);
+            freesBefore = numMemoryFrees;
+        }
+
+        if (!swapInProcess(process, node)) {
+            ++numFailedSwapIns;
+
+            // Retrying before memory is freed would only fail again, the process stays off the ready queue until deallocate
+            std::unique_lock<std::mutex> lock(swapInMutex);
+            if (numMemoryFrees == freesBefore) {
+                waitingSwapIns.push_back({ process, node, start });
+                return;
+            }
+            lock.unlock();
+            submitSwapIn(process, node, start); // memory was freed during the attempt
+            return;
+        }
+
+        ++numSwapIns;
+        process->recordSwapIn(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        {
+            std::lock_guard<std::mutex> lock(swapInMutex);
+            swappingIn.erase(process->getID());
+        }
+        scheduler->resumeProcess(process);
+        });
+}
+
+bool MemoryManager::isResident(int pid) {
+    if (allocationType == "paging") {
+        return pagingAllocator.isResident(pid);
+    }
+
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return swappedOutProcesses.find(pid) == swappedOutProcesses.end();
+}
+
+bool MemoryManager::swapInProcess(std::shared_ptr<Process> process, int node) {
+    int pid = process->getID();
+    if (allocationType == "paging") {
+        // Pages outside the working set come back on demand
+        pagingAllocator.swapInProcess(pid, node);
+        return true;
+    }
+
+    // Flat and buddy processes come back whole, sized by their record in the backing store
+    std::shared_ptr<Process> record;
+    try {
+        record = swapIO.loadProcess(pid);
+    }
+    catch (const std::exception&) {
+        record = process; // the store was lost, the process itself knows its size
+    }
+    // Evicting a ready process here would only send it through a swap-in of its own, the process waits for free memory instead
+    if (!allocate(*record, false)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        auto swapped = swappedOutProcesses.find(pid);
+        if (swapped != swappedOutProcesses.end()) {
+            swappedOutMemory -= swapped->second;
+            swappedOutProcesses.erase(swapped);
+        }
+    }
+    swapIO.submitRemove(pid);
+    return true;
+}
+
+long long MemoryManager::getNumSwapIns() const {
+    return numSwapIns;
+}
+
+long long MemoryManager::getNumFailedSwapIns() const {
+    return numFailedSwapIns;
+}
+
+int MemoryManager::getNumSwapInsInProgress() {
+    std::lock_guard<std::mutex> lock(swapInMutex);
+    return static_cast<int>(swappingIn.size());
+}
+
+bool MemoryManager::isSwappedOut(int pid) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return swappedOutProcesses.find(pid) != swappedOutProcesses.end();
+}
+
+std::unordered_map<int, std::vector<std::pair<int, int>>> MemoryManager::getResidentPages() {
+    if (allocationType != "paging") {
+        return {};
+    }
+    return pagingAllocator.getResidentPages();
+}
+
+void MemoryManager::restoreProcess(std::shared_ptr<Process> process, bool swappedOut, const std::vector<std::pair<int, int>>& residentPages) {
+    if (allocationType == "paging") {
+        // The page table comes back empty, the resident pages are loaded again and the swapped ones fault in on demand
+        if (allocate(*process)) {
+            pagingAllocator.restorePages(process->getID(), residentPages);
+        }
+        return;
+    }
+
+    if (!swappedOut && allocate(*process)) {
+        return;
+    }
+
+    // The process goes back to the backing store, the next dispatch swaps it in
+    swapIO.submitStore(process);
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    swappedOutProcesses[process->getID()] = static_cast<int>(process->getMemorySize());
+    swappedOutMemory += static_cast<int>(process->getMemorySize());
+}
+
+void MemoryManager::deallocate(const std::vector<int>& pids) {
+    std::vector<int> storedPIDs;
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        for (int pid : pids) {
+            auto swapped = swappedOutProcesses.find(pid);
+            if (swapped != swappedOutProcesses.end()) {
+                swappedOutMemory -= swapped->second;
+                swappedOutProcesses.erase(swapped);
+                storedPIDs.push_back(pid);
+            }
+        }
+
+        // Paging also frees the processes' swap slots
+        if (allocationType == "flat") {
+            flatAllocator.deallocate(pids);
+        }
+        else if (allocationType == "paging") {
+            pagingAllocator.deallocate(pids);
+        }
+        else if (allocationType == "buddy") {
+            for (int pid : pids) {
+                buddyAllocator.deallocate(pid);
+            }
+        }
+    }
+
+    // A process swapped out whole still has its record, dropped once any store queued for it is done
+    for (int pid : storedPIDs) {
+        swapIO.submitRemove(pid);
+    }
+
+    // Swap-ins that found no memory try again
+    std::vector<WaitingSwapIn> waiting;
+    {
+        std::lock_guard<std::mutex> lock(swapInMutex);
+        ++numMemoryFrees;
+        waiting.swap(waitingSwapIns);
+    }
+    for (const auto& swapIn : waiting) {
+        submitSwapIn(swapIn.process, swapIn.node, swapIn.start);
     }
+
+    if (memoryFreedCallback) {
+        memoryFreedCallback();
+    }
+}
+
+void MemoryManager::releaseProcess(int pid) {
+    {
+        std::lock_guard<std::mutex> lock(reclaimMutex);
+        pendingReleases.push_back({ pid, std::chrono::steady_clock::now() });
+    }
+    reclaimWakeup.notify_one();
+}
+
+void MemoryManager::releaseFinishedProcesses() {
+    std::vector<PendingRelease> batch;
+    {
+        std::lock_guard<std::mutex> lock(reclaimMutex);
+        batch.swap(pendingReleases);
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<int> pids;
+    pids.reserve(batch.size());
+    for (const auto& release : batch) {
+        pids.push_back(release.pid);
+    }
+    deallocate(pids); // wakes the admission queue once for the whole batch
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    ++numReleaseBatches;
+    largestReleaseBatch = std::max(largestReleaseBatch, static_cast<int>(batch.size()));
+    for (const auto& release : batch) {
+        long long latency = std::chrono::duration_cast<std::chrono::microseconds>(now - release.finishTime).count();
+        ++numProcessesReleased;
+        totalReleaseLatency += latency;
+        maxReleaseLatency = std::max(maxReleaseLatency, latency);
+        ++releaseLatencyHistogram[SwapIOEngine::getLatencyBucket(latency)];
+    }
+}
+
+long long MemoryManager::getNumProcessesReleased() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return numProcessesReleased;
+}
+
+long long MemoryManager::getNumReleaseBatches() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return numReleaseBatches;
+}
+
+int MemoryManager::getLargestReleaseBatch() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return largestReleaseBatch;
+}
+
+long long MemoryManager::getAverageReleaseLatency() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return numProcessesReleased > 0 ? totalReleaseLatency / numProcessesReleased : 0;
+}
+
+long long MemoryManager::getMaxReleaseLatency() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return maxReleaseLatency;
+}
+
+std::vector<long long> MemoryManager::getReleaseLatencyHistogram() {
+    std::lock_guard<std::mutex> lock(releaseStatsMutex);
+    return releaseLatencyHistogram;
+}
+
+void MemoryManager::setMemoryFreedCallback(std::function<void()> callback) {
+    memoryFreedCallback = callback;
 }
 
 void MemoryManager::stop() {
     running = false;
+    reclaimWakeup.notify_all();
+    if (memoryThread.joinable()) {
+        memoryThread.join();
+    }
+    swapIO.stop(); // swap-ins still queued finish first, later ones run on the caller
 }
 
 void MemoryManager::run() {
     while (running) {
-        // Perform periodic memory management tasks
-        // For example: Check memory status, handle requests, etc.
+        releaseFinishedProcesses();
 
-        // Here, we'll just simulate work with sleep
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Adjust as needed
+        // Compact the flat memory a few blocks at a time so allocations rarely have to wait for it
+        if (allocationType == "flat") {
+            flatAllocator.compact(COMPACTION_MOVES_PER_TICK); // skips arenas that are not fragmented
+        }
+        else if (allocationType == "paging") {
+            updateFaultFrequency();
+            reclaimPages();
+            pagingAllocator.promoteHugePages(HUGE_PAGE_PROMOTIONS_PER_TICK); // does nothing if huge pages are off
+        }
+
+        // Processes swapped back in leave dead records behind, rewrite the file once they outnumber the live ones
+        if (backingStore.needsCompaction()) {
+            backingStore.compact();
+        }
+
+        // Sleep until the next tick, a page fault below the low watermark or a finished process wakes the thread early
+        std::unique_lock<std::mutex> lock(reclaimMutex);
+        if (pendingReleases.empty()) {
+            reclaimWakeup.wait_for(lock, std::chrono::milliseconds(100));
+        }
     }
 }
 
-std::unordered_set<int> MemoryManager::getRunningProcessIDs() const {
+void MemoryManager::reclaimPages() {
+    if (pagingAllocator.getNumFreeFrames() >= lowWatermark) {
+        return;
+    }
+    ++numReclaimWakeups;
+
+    // Evict in batches, faulting cores can take the allocator lock in between
+    while (running) {
+        int freeFrames = pagingAllocator.getNumFreeFrames();
+        if (freeFrames >= highWatermark) {
+            break;
+        }
+
+        int reclaimed = pagingAllocator.reclaimPages(std::min(RECLAIM_BATCH_PAGES, highWatermark - freeFrames));
+        if (reclaimed == 0) {
+            break; // nothing resident to evict
+        }
+    }
+}
+
+long long MemoryManager::getNumReclaimWakeups() const {
+    return numReclaimWakeups;
+}
+
+int MemoryManager::getLowWatermark() const {
+    return lowWatermark;
+}
+
+int MemoryManager::getHighWatermark() const {
+    return highWatermark;
+}
+
+long long MemoryManager::getNumProcessesSwappedOut() const {
+    return numProcessesSwappedOut;
+}
+
+std::vector<int64_t> MemoryManager::getPageReferenceTrace() {
+    return pagingAllocator.getReferenceTrace();
+}
+
+void MemoryManager::updateFaultFrequency() {
+    long long references = pagingAllocator.getNumPageReferences();
+    long long majorFaults = pagingAllocator.getNumMajorFaults();
+
+    // Page-fault frequency: only major faults count, first touches are expected from every new process
+    long long newReferences = references - lastPageReferences;
+    double sample = newReferences > 0 ? (majorFaults - lastMajorFaults) * 100.0 / newReferences : 0;
+    lastPageReferences = references;
+    lastMajorFaults = majorFaults;
+
+    double faultRate = FAULT_RATE_SMOOTHING * sample + (1 - FAULT_RATE_SMOOTHING) * recentFaultRate;
+    recentFaultRate = faultRate;
+
+    // Clear only well below the threshold so admission does not flap
+    double threshold = configManager->getThrashFaultRate();
+    if (faultRate >= threshold) {
+        thrashing = true;
+    }
+    else if (faultRate < threshold / 2) {
+        thrashing = false;
+    }
+}
+
+bool MemoryManager::isThrashing() const {
+    return thrashing;
+}
+
+double MemoryManager::getRecentFaultRate() const {
+    return recentFaultRate;
+}
+
+int MemoryManager::getWorkingSetSize(int pid) {
+    return pagingAllocator.getWorkingSetSize(pid);
+}
+
+int MemoryManager::getTotalWorkingSetSize() {
+    std::vector<std::pair<int, int>> sizes = pagingAllocator.getWorkingSetSizes();
+
+    // Finished processes keep their pages until the memory thread releases them but no longer need them
+    int total = 0;
+    for (const auto& entry : sizes) {
+        std::shared_ptr<Process> process = scheduler->getProcessByID(entry.first);
+        if (process && !process->isFinished()) {
+            total += entry.second;
+        }
+    }
+    return total;
+}
+
+std::unordered_set<int> MemoryManager::getUnevictableProcessIDs() {
     std::unordered_set<int> runningProcessIDs;
     for (const auto& core : scheduler->getCores()) {
         auto process = core->getCurrentProcess();
@@ -115,28 +565,63 @@ std::unordered_set<int> MemoryManager::getRunningProcessIDs() const {
             runningProcessIDs.insert(process->getID());
         }
     }
+
+    // A process found resident at dispatch has not reached its core yet, one being swapped in is not marked resident yet
+    int dispatchingProcessID = scheduler->getDispatchingProcessID();
+    if (dispatchingProcessID != -1) {
+        runningProcessIDs.insert(dispatchingProcessID);
+    }
+    std::lock_guard<std::mutex> lock(swapInMutex);
+    runningProcessIDs.insert(swappingIn.begin(), swappingIn.end());
     return runningProcessIDs;
 }
 
+SwapIOEngine* MemoryManager::getSwapIO() {
+    return &swapIO;
+}
+
+CompressedSwapPool* MemoryManager::getSwapPool() {
+    return &swapPool;
+}
+
 BackingStore* MemoryManager::getBackingStore() {
     return &backingStore;
 }
 
 int MemoryManager::getUsedMemory() {
-    int totalActiveMemory = 0;
     if (allocationType == "flat") {
-        totalActiveMemory = flatAllocator.getUsedMemory();
+        return flatAllocator.getUsedMemory();
     }
     else if (allocationType == "paging") {
-        std::vector<int> processIDs = pagingAllocator.getProcessKeys();
-        std::vector<std::shared_ptr<Process>> allocatedProcesses;
+        return pagingAllocator.getUsedMemory();
+    }
+    else if (allocationType == "buddy") {
+        return buddyAllocator.getUsedMemory();
+    }
+    return 0;
+}
 
-        for (const auto& id : processIDs) {
-            std::shared_ptr<Process> temp = scheduler->getProcessByID(id);
-            allocatedProcesses.push_back(temp);
-        }
+int MemoryManager::getFreeMemory() {
+    return static_cast<int>(configManager->getMaxOverallMemory()) - getUsedMemory();
+}
+
+int MemoryManager::getActiveMemory() {
+    return getUsedMemory();
+}
+
+int MemoryManager::getLargestFreeBuddyBlock() {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return buddyAllocator.getLargestFreeBlock();
+}
+
+float MemoryManager::getBuddyInternalFragmentation() {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return buddyAllocator.getInternalFragmentation();
+}
 
-        totalActiveMemory = pagingAllocator.getUsedMemory(allocatedProcesses);
+int MemoryManager::getInactiveMemory() {
+    if (allocationType == "paging") {
+        return pagingAllocator.getSwappedMemory();
     }
-    return totalActiveMemory;
+    return swappedOutMemory;
 }
@@ -2,34 +2,82 @@
 
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <chrono>
 
 #include "ConfigurationManager.h"
 #include "Process.h"
 #include "Scheduler.h"
 #include "BackingStore.h"
-#include "FlatAllocator.h"
+#include "SwapIOEngine.h"
+#include "CompressedSwapPool.h"
+#include "ShardedFlatAllocator.h"
 #include "PagingAllocator.h"
+#include "BuddyAllocator.h"
 
 class MemoryManager
 {
 public:
     MemoryManager();
     ~MemoryManager();
-    FlatAllocator flatAllocator;
+    ShardedFlatAllocator flatAllocator;
     PagingAllocator pagingAllocator;
+    BuddyAllocator buddyAllocator;
 
     bool initialize(ConfigurationManager* configManager, Scheduler* scheduler);
-    bool allocate(Process process);
-    void deallocate(int pid);
+    bool allocate(Process process, bool swapOut = true); // swapOut false only takes free memory, compacting first, and evicts no other process
+    void deallocate(const std::vector<int>& pids); // frees the memory, swap slots and backing store records of the processes, one lock hold for all
+    void releaseProcess(int pid); // the process finished, the memory thread frees it with the next batch
+    void setMemoryFreedCallback(std::function<void()> callback); // called after deallocate, processes waiting for memory can retry
+    MemoryAccess accessMemory(std::shared_ptr<Process> process, int node); // Memory reference of the process's next instruction from a core on the node
+    void recordTLBHits(std::shared_ptr<Process> process, const std::vector<int>& addresses); // references a core translated without asking, paging only
+    bool swapIn(std::shared_ptr<Process> process, int node); // At dispatch: true if the process is resident, else it is swapped in on the swap I/O workers and handed back to the scheduler
 
-    void stop(); // Method to stop the thread
+    void stop(); // Stops the memory thread and the swap I/O workers, both call into the scheduler
     BackingStore* getBackingStore();
+    SwapIOEngine* getSwapIO();
+    CompressedSwapPool* getSwapPool();
 
-    // Get total active memory
-    int getActiveMemory();
-    int getUsedMemory();
-    int getInactiveMemory();
+    // Memory usage, kept up to date by the allocators so reads are O(1) and take no locks
+    int getUsedMemory(); // process memory in RAM
+    int getFreeMemory();
+    int getActiveMemory(); // same as used, process memory in RAM
+    int getInactiveMemory(); // process memory that only lives in the backing store
+    int getLargestFreeBuddyBlock(); // buddy stats walk the allocator's state, they are read under the allocator lock
+    float getBuddyInternalFragmentation();
+
+    long long getNumProcessesSwappedOut() const;
+    long long getNumSwapIns() const; // processes brought back at dispatch
+    long long getNumFailedSwapIns() const; // swap-ins that found no memory, retried once memory is freed
+    int getNumSwapInsInProgress();
+    std::vector<int64_t> getPageReferenceTrace(); // copy of the paging reference trace, taken under the allocator lock
+
+    // Checkpoint
+    bool isSwappedOut(int pid); // flat and buddy processes swapped out whole
+    std::unordered_map<int, std::vector<std::pair<int, int>>> getResidentPages(); // paging: pid -> (page number, NUMA node) of every resident page
+    void restoreProcess(std::shared_ptr<Process> process, bool swappedOut, const std::vector<std::pair<int, int>>& residentPages); // memory of a process restored from a checkpoint, swapped out if it no longer fits
+
+    // Load control (paging)
+    bool isThrashing() const; // major page-fault frequency is above thrash-fault-rate
+    double getRecentFaultRate() const; // smoothed major faults per 100 references
+    int getWorkingSetSize(int pid);
+    int getTotalWorkingSetSize(); // pages, over the processes that have not finished
+
+    // Background reclaim (paging)
+    long long getNumReclaimWakeups() const;
+    int getLowWatermark() const; // frames
+    int getHighWatermark() const; // frames
+
+    // Memory released on process completion
+    long long getNumProcessesReleased();
+    long long getNumReleaseBatches();
+    int getLargestReleaseBatch();
+    long long getAverageReleaseLatency(); // microseconds from finish to memory freed
+    long long getMaxReleaseLatency();
+    std::vector<long long> getReleaseLatencyHistogram(); // SwapIOEngine latency buckets
 
 private:
     void run(); // Method that the thread will execute
@@ -37,12 +85,71 @@ private:
     ConfigurationManager* configManager;
     Scheduler* scheduler;
     BackingStore backingStore;
+    SwapIOEngine swapIO; // after the backing store, its workers write to it until they stop
+    CompressedSwapPool swapPool; // compressed pages in front of swapIO, pages it writes back go through the queue
 
     std::string allocationType;
 
     std::thread memoryThread;
     std::atomic<bool> running;
+    std::mutex allocatorMutex; // Serializes the flat swap-out path and the buddy allocator, the flat arenas and the paging allocator lock themselves
+    std::function<void()> memoryFreedCallback;
+
+    std::atomic<long long> numProcessesSwappedOut;
+    std::unordered_map<int, int> swappedOutProcesses; // pid -> memory, flat and buddy processes that were swapped out whole
+    std::atomic<int> swappedOutMemory;
+
+    std::mutex swapInMutex;
+    std::unordered_set<int> swappingIn; // pids parked off the ready queue until their swap-in is done
+    std::atomic<long long> numSwapIns;
+    std::atomic<long long> numFailedSwapIns;
+
+    // Flat and buddy swap-ins that found no memory, resubmitted by the next deallocate
+    struct WaitingSwapIn {
+        std::shared_ptr<Process> process;
+        int node;
+        std::chrono::steady_clock::time_point start;
+    };
+    std::vector<WaitingSwapIn> waitingSwapIns; // guarded by swapInMutex
+    long long numMemoryFrees; // deallocate calls, a swap-in that failed while memory was freed retries at once
+
+    void submitSwapIn(std::shared_ptr<Process> process, int node, std::chrono::steady_clock::time_point start);
+
+    bool isResident(int pid);
+    bool swapInProcess(std::shared_ptr<Process> process, int node); // runs on a swap I/O worker, false if there was no memory for the process
+
+    std::atomic<bool> thrashing;
+    std::atomic<double> recentFaultRate;
+    long long lastPageReferences; // counters at the previous fault-frequency sample
+    long long lastMajorFaults;
+
+    void updateFaultFrequency(); // samples the major fault rate and sets or clears thrashing
+
+    // kswapd-like reclaim: woken when free frames drop below the low watermark, evicts until the high one
+    std::mutex reclaimMutex;
+    std::condition_variable reclaimWakeup;
+    std::atomic<long long> numReclaimWakeups;
+    int lowWatermark;
+    int highWatermark;
+
+    void reclaimPages();
+
+    // Finished processes queue up and the memory thread frees them in batches, a burst of completions takes each allocator lock once
+    struct PendingRelease {
+        int pid;
+        std::chrono::steady_clock::time_point finishTime;
+    };
+    std::vector<PendingRelease> pendingReleases; // guarded by reclaimMutex so a release never misses the thread's wakeup
+    std::mutex releaseStatsMutex;
+    long long numProcessesReleased;
+    long long numReleaseBatches;
+    int largestReleaseBatch;
+    long long totalReleaseLatency;
+    long long maxReleaseLatency;
+    std::vector<long long> releaseLatencyHistogram;
+
+    void releaseFinishedProcesses();
 
-    std::unordered_set<int> getRunningProcessIDs() const; // get running process IDs
+    std::unordered_set<int> getUnevictableProcessIDs(); // running, being dispatched or being swapped in
 
 };
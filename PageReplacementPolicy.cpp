@@ -0,0 +1,323 @@
+#include "PageReplacementPolicy.h"
+#include <set>
+#include <unordered_map>
+
+namespace {
+    const int RANDOM_VICTIM_TRIES = 16; // random picks before falling back to a scan of the resident frames
+
+    // Indexed set helpers shared by the policies that keep a list of resident frames
+    void addResidentFrame(std::vector<int>& frames, std::vector<int>& position, int frame) {
+        if (position[frame] == -1) {
+            position[frame] = static_cast<int>(frames.size());
+            frames.push_back(frame);
+        }
+    }
+
+    void removeResidentFrame(std::vector<int>& frames, std::vector<int>& position, int frame) {
+        int index = position[frame];
+        if (index == -1) {
+            return;
+        }
+
+        // move the last frame into the hole
+        int lastFrame = frames.back();
+        frames[index] = lastFrame;
+        position[lastFrame] = index;
+        frames.pop_back();
+        position[frame] = -1;
+    }
+}
+
+std::unique_ptr<PageReplacementPolicy> PageReplacementPolicy::create(const std::string& name) {
+    if (name == "random") {
+        return std::unique_ptr<PageReplacementPolicy>(new RandomReplacementPolicy());
+    }
+    else if (name == "fifo") {
+        return std::unique_ptr<PageReplacementPolicy>(new FifoReplacementPolicy());
+    }
+    else if (name == "lru") {
+        return std::unique_ptr<PageReplacementPolicy>(new LruReplacementPolicy());
+    }
+    else if (name == "clock") {
+        return std::unique_ptr<PageReplacementPolicy>(new ClockReplacementPolicy());
+    }
+    return nullptr;
+}
+
+std::vector<std::string> PageReplacementPolicy::getPolicyNames() {
+    return { "random", "fifo", "lru", "clock", "opt" };
+}
+
+PageReplacementPolicy::SimulationResult PageReplacementPolicy::simulate(const std::string& name, const std::vector<int64_t>& trace, int numFrames) {
+    SimulationResult result = { static_cast<long long>(trace.size()), 0, 0 };
+    if (numFrames <= 0) {
+        return result;
+    }
+
+    if (name == "opt") {
+        // Belady: evict the resident page whose next reference is furthest away
+        std::vector<size_t> nextUse(trace.size());
+        std::unordered_map<int64_t, size_t> lastSeen;
+        for (size_t i = trace.size(); i-- > 0;) {
+            auto it = lastSeen.find(trace[i]);
+            nextUse[i] = it != lastSeen.end() ? it->second : trace.size();
+            lastSeen[trace[i]] = i;
+        }
+
+        std::set<std::pair<size_t, int64_t>> residentByNextUse;
+        std::unordered_map<int64_t, size_t> residentNextUse;
+        for (size_t i = 0; i < trace.size(); ++i) {
+            auto it = residentNextUse.find(trace[i]);
+            if (it != residentNextUse.end()) {
+                residentByNextUse.erase({ it->second, trace[i] });
+            }
+            else {
+                ++result.faults;
+                if (static_cast<int>(residentNextUse.size()) == numFrames) {
+                    auto victim = std::prev(residentByNextUse.end());
+                    residentNextUse.erase(victim->second);
+                    residentByNextUse.erase(victim);
+                    ++result.evictions;
+                }
+            }
+            residentNextUse[trace[i]] = nextUse[i];
+            residentByNextUse.insert({ nextUse[i], trace[i] });
+        }
+        return result;
+    }
+
+    std::unique_ptr<PageReplacementPolicy> policy = create(name);
+    if (!policy) {
+        return result;
+    }
+    policy->initialize(numFrames);
+
+    std::unordered_map<int64_t, int> pageFrames; // page -> frame
+    std::vector<int64_t> framePages(numFrames, -1); // frame -> page
+    int nextFreeFrame = 0;
+    for (int64_t page : trace) {
+        auto it = pageFrames.find(page);
+        if (it != pageFrames.end()) {
+            policy->onPageAccessed(it->second);
+            continue;
+        }
+
+        ++result.faults;
+        int frame = nextFreeFrame < numFrames ? nextFreeFrame++ : policy->selectVictim([](int) { return true; });
+        if (framePages[frame] != -1) {
+            pageFrames.erase(framePages[frame]);
+            policy->onPageRemoved(frame);
+            ++result.evictions;
+        }
+        framePages[frame] = page;
+        pageFrames[page] = frame;
+        policy->onPageLoaded(frame);
+    }
+    return result;
+}
+
+// Random
+
+void RandomReplacementPolicy::initialize(int numFrames) {
+    residentFrames.clear();
+    residentPosition.assign(numFrames, -1);
+}
+
+void RandomReplacementPolicy::onPageLoaded(int frame) {
+    addResidentFrame(residentFrames, residentPosition, frame);
+}
+
+void RandomReplacementPolicy::onPageAccessed(int /*frame*/) {}
+
+void RandomReplacementPolicy::onPageRemoved(int frame) {
+    removeResidentFrame(residentFrames, residentPosition, frame);
+}
+
+int RandomReplacementPolicy::selectVictim(const std::function<bool(int)>& canEvict) {
+    if (residentFrames.empty()) {
+        return -1;
+    }
+
+    // Most frames can be evicted, so a few random picks almost always find one
+    std::uniform_int_distribution<size_t> dis(0, residentFrames.size() - 1);
+    for (int i = 0; i < RANDOM_VICTIM_TRIES; ++i) {
+        int frame = residentFrames[dis(generator)];
+        if (canEvict(frame)) {
+            return frame;
+        }
+    }
+
+    for (int frame : residentFrames) {
+        if (canEvict(frame)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+std::string RandomReplacementPolicy::getName() const {
+    return "random";
+}
+
+// FIFO
+
+void FifoReplacementPolicy::initialize(int numFrames) {
+    nextLoaded.assign(numFrames, -1);
+    previousLoaded.assign(numFrames, -1);
+    linked.assign(numFrames, 0);
+    oldestFrame = -1;
+    newestFrame = -1;
+}
+
+void FifoReplacementPolicy::onPageLoaded(int frame) {
+    unlink(frame); // a reloaded frame goes to the back
+
+    previousLoaded[frame] = newestFrame;
+    nextLoaded[frame] = -1;
+    if (newestFrame != -1) {
+        nextLoaded[newestFrame] = frame;
+    }
+    else {
+        oldestFrame = frame;
+    }
+    newestFrame = frame;
+    linked[frame] = 1;
+}
+
+void FifoReplacementPolicy::onPageAccessed(int /*frame*/) {}
+
+void FifoReplacementPolicy::onPageRemoved(int frame) {
+    unlink(frame);
+}
+
+void FifoReplacementPolicy::unlink(int frame) {
+    if (!linked[frame]) {
+        return;
+    }
+
+    if (previousLoaded[frame] != -1) {
+        nextLoaded[previousLoaded[frame]] = nextLoaded[frame];
+    }
+    else {
+        oldestFrame = nextLoaded[frame];
+    }
+    if (nextLoaded[frame] != -1) {
+        previousLoaded[nextLoaded[frame]] = previousLoaded[frame];
+    }
+    else {
+        newestFrame = previousLoaded[frame];
+    }
+    nextLoaded[frame] = -1;
+    previousLoaded[frame] = -1;
+    linked[frame] = 0;
+}
+
+int FifoReplacementPolicy::selectVictim(const std::function<bool(int)>& canEvict) {
+    for (int frame = oldestFrame; frame != -1; frame = nextLoaded[frame]) {
+        if (canEvict(frame)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+std::string FifoReplacementPolicy::getName() const {
+    return "fifo";
+}
+
+// LRU (aging)
+
+void LruReplacementPolicy::initialize(int numFrames) {
+    residentFrames.clear();
+    residentPosition.assign(numFrames, -1);
+    age.assign(numFrames, 0);
+    referenced.assign(numFrames, 0);
+}
+
+void LruReplacementPolicy::onPageLoaded(int frame) {
+    addResidentFrame(residentFrames, residentPosition, frame);
+    age[frame] = 0;
+    referenced[frame] = 1;
+}
+
+void LruReplacementPolicy::onPageAccessed(int frame) {
+    referenced[frame] = 1;
+}
+
+void LruReplacementPolicy::onPageRemoved(int frame) {
+    removeResidentFrame(residentFrames, residentPosition, frame);
+    referenced[frame] = 0;
+}
+
+int LruReplacementPolicy::selectVictim(const std::function<bool(int)>& canEvict) {
+    int victim = -1;
+    for (int frame : residentFrames) {
+        age[frame] = static_cast<uint8_t>((age[frame] >> 1) | (referenced[frame] << 7));
+        referenced[frame] = 0;
+
+        if ((victim == -1 || age[frame] < age[victim]) && canEvict(frame)) {
+            victim = frame;
+        }
+    }
+    return victim;
+}
+
+std::string LruReplacementPolicy::getName() const {
+    return "lru";
+}
+
+// CLOCK / second chance
+
+void ClockReplacementPolicy::initialize(int numFrames) {
+    resident.assign(numFrames, 0);
+    referenced.assign(numFrames, 0);
+    hand = 0;
+    numResident = 0;
+}
+
+void ClockReplacementPolicy::onPageLoaded(int frame) {
+    if (!resident[frame]) {
+        ++numResident;
+    }
+    resident[frame] = 1;
+    referenced[frame] = 1;
+}
+
+void ClockReplacementPolicy::onPageAccessed(int frame) {
+    referenced[frame] = 1;
+}
+
+void ClockReplacementPolicy::onPageRemoved(int frame) {
+    if (resident[frame]) {
+        --numResident;
+    }
+    resident[frame] = 0;
+    referenced[frame] = 0;
+}
+
+int ClockReplacementPolicy::selectVictim(const std::function<bool(int)>& canEvict) {
+    int numFrames = static_cast<int>(resident.size());
+    if (numResident == 0) {
+        return -1;
+    }
+
+    // Two turns are enough: the first one clears every reference bit it passes
+    for (int step = 0; step < 2 * numFrames; ++step) {
+        int frame = hand;
+        hand = (hand + 1) % numFrames;
+
+        if (!resident[frame] || !canEvict(frame)) {
+            continue;
+        }
+        if (referenced[frame]) {
+            referenced[frame] = 0; // second chance
+            continue;
+        }
+        return frame;
+    }
+    return -1;
+}
+
+std::string ClockReplacementPolicy::getName() const {
+    return "clock";
+}
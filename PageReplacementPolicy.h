@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <random>
+#include <functional>
+#include <cstdint>
+
+// Decides which frame the paging allocator evicts when memory is full
+// The allocator reports every load, reference and removal of a frame; the policy only sees frame numbers
+class PageReplacementPolicy
+{
+public:
+	virtual ~PageReplacementPolicy() = default;
+
+	virtual void initialize(int numFrames) = 0;
+	virtual void onPageLoaded(int frame) = 0;	// a page was placed in the frame
+	virtual void onPageAccessed(int frame) = 0;	// the page in the frame was referenced (sets its reference bit)
+	virtual void onPageRemoved(int frame) = 0;	// the frame was freed or evicted
+	virtual int selectVictim(const std::function<bool(int)>& canEvict) = 0; // frame to evict, -1 if none can be evicted
+	virtual std::string getName() const = 0;
+
+	static std::unique_ptr<PageReplacementPolicy> create(const std::string& name); // "random", "fifo", "lru" or "clock"
+
+	// Offline replay of a page reference string with a fixed number of frames
+	// Supports every online policy plus "opt" (Belady), which needs to know the future references
+	struct SimulationResult {
+		long long references;
+		long long faults;
+		long long evictions;
+	};
+	static SimulationResult simulate(const std::string& name, const std::vector<int64_t>& trace, int numFrames);
+	static std::vector<std::string> getPolicyNames(); // every policy that simulate() supports
+};
+
+// Evicts a random resident frame
+class RandomReplacementPolicy : public PageReplacementPolicy
+{
+public:
+	void initialize(int numFrames) override;
+	void onPageLoaded(int frame) override;
+	void onPageAccessed(int frame) override;
+	void onPageRemoved(int frame) override;
+	int selectVictim(const std::function<bool(int)>& canEvict) override;
+	std::string getName() const override;
+
+private:
+	std::vector<int> residentFrames; // in no particular order
+	std::vector<int> residentPosition; // frame -> index in residentFrames, -1 if not resident
+	std::mt19937 generator{ std::random_device{}() };
+};
+
+// Evicts the frame that was loaded first
+class FifoReplacementPolicy : public PageReplacementPolicy
+{
+public:
+	void initialize(int numFrames) override;
+	void onPageLoaded(int frame) override;
+	void onPageAccessed(int frame) override;
+	void onPageRemoved(int frame) override;
+	int selectVictim(const std::function<bool(int)>& canEvict) override;
+	std::string getName() const override;
+
+private:
+	// Resident frames in load order as a list threaded through per-frame links, a removal unlinks the frame in O(1)
+	std::vector<int> nextLoaded; // frame -> frame loaded after it, -1 at the tail
+	std::vector<int> previousLoaded; // frame -> frame loaded before it, -1 at the head
+	std::vector<uint8_t> linked;
+	int oldestFrame = -1;
+	int newestFrame = -1;
+
+	void unlink(int frame);
+};
+
+// Approximates LRU with reference bits (aging): every eviction shifts each frame's
+// reference bit into an 8-bit age, and the frame with the lowest age is evicted
+class LruReplacementPolicy : public PageReplacementPolicy
+{
+public:
+	void initialize(int numFrames) override;
+	void onPageLoaded(int frame) override;
+	void onPageAccessed(int frame) override;
+	void onPageRemoved(int frame) override;
+	int selectVictim(const std::function<bool(int)>& canEvict) override;
+	std::string getName() const override;
+
+private:
+	std::vector<int> residentFrames;
+	std::vector<int> residentPosition;
+	std::vector<uint8_t> age;
+	std::vector<uint8_t> referenced;
+};
+
+// CLOCK / second chance: the hand skips (and clears) frames whose reference bit is set
+class ClockReplacementPolicy : public PageReplacementPolicy
+{
+public:
+	void initialize(int numFrames) override;
+	void onPageLoaded(int frame) override;
+	void onPageAccessed(int frame) override;
+	void onPageRemoved(int frame) override;
+	int selectVictim(const std::function<bool(int)>& canEvict) override;
+	std::string getName() const override;
+
+private:
+	std::vector<uint8_t> resident;
+	std::vector<uint8_t> referenced;
+	int hand = 0;
+	int numResident = 0;
+};
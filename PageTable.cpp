@@ -0,0 +1,424 @@
+#include "PageTable.h"
+
+namespace {
+    const int NODE_BITS = 9; // page number bits resolved by each radix level
+    const int NODE_SIZE = 1 << NODE_BITS;
+    const int NODE_MASK = NODE_SIZE - 1;
+
+    // Rough cost of a node in an unordered_map: the node's next pointer plus its bucket pointer
+    const size_t HASH_NODE_OVERHEAD = 2 * sizeof(void*);
+}
+
+std::unique_ptr<PageTable> PageTable::create(const std::string& name) {
+    if (name == "linear") {
+        return std::unique_ptr<PageTable>(new LinearPageTable());
+    }
+    else if (name == "radix2") {
+        return std::unique_ptr<PageTable>(new RadixPageTable(2));
+    }
+    else if (name == "radix3") {
+        return std::unique_ptr<PageTable>(new RadixPageTable(3));
+    }
+    else if (name == "inverted") {
+        return std::unique_ptr<PageTable>(new InvertedPageTable());
+    }
+    return nullptr;
+}
+
+std::vector<std::string> PageTable::getPageTableNames() {
+    return { "linear", "radix2", "radix3", "inverted" };
+}
+
+PageTableEntry PageTable::lookup(int pid, int pageNumber) {
+    int steps = 0;
+    PageTableEntry entry = walk(pid, pageNumber, steps);
+    ++numLookups;
+    numLookupSteps += steps;
+    return entry;
+}
+
+long long PageTable::getNumLookups() const {
+    return numLookups;
+}
+
+double PageTable::getAverageLookupSteps() const {
+    return numLookups ? static_cast<double>(numLookupSteps) / numLookups : 0;
+}
+
+// Linear
+
+void LinearPageTable::initialize(int /*numFrames*/) {
+    processPageTable.clear();
+}
+
+void LinearPageTable::addProcess(int pid, int numPages) {
+    processPageTable[pid] = std::vector<PageTableEntry>(numPages, { -1, false });
+}
+
+void LinearPageTable::removeProcess(int pid, const std::function<void(int)>& onResidentFrame) {
+    auto it = processPageTable.find(pid);
+    if (it == processPageTable.end()) {
+        return;
+    }
+
+    for (const auto& entry : it->second) {
+        if (entry.frame != -1) {
+            onResidentFrame(entry.frame);
+        }
+    }
+    processPageTable.erase(it);
+}
+
+int LinearPageTable::getNumPages(int pid) const {
+    auto it = processPageTable.find(pid);
+    return it != processPageTable.end() ? static_cast<int>(it->second.size()) : 0;
+}
+
+PageTableEntry LinearPageTable::walk(int pid, int pageNumber, int& steps) const {
+    ++steps; // hash lookup of the process
+    auto it = processPageTable.find(pid);
+    if (it == processPageTable.end() || pageNumber >= static_cast<int>(it->second.size())) {
+        return { -1, false };
+    }
+
+    ++steps;
+    return it->second[pageNumber];
+}
+
+void LinearPageTable::map(int pid, int pageNumber, int frame) {
+    processPageTable[pid][pageNumber].frame = frame;
+}
+
+void LinearPageTable::unmap(int pid, int pageNumber) {
+    PageTableEntry& entry = processPageTable[pid][pageNumber];
+    entry.frame = -1;
+    entry.swapped = true;
+}
+
+std::vector<int> LinearPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& entry : processPageTable) {
+        processIDs.push_back(entry.first);
+    }
+    return processIDs;
+}
+
+size_t LinearPageTable::getFootprint() const {
+    size_t bytes = processPageTable.bucket_count() * sizeof(void*);
+    for (const auto& entry : processPageTable) {
+        bytes += sizeof(entry) + HASH_NODE_OVERHEAD + entry.second.capacity() * sizeof(PageTableEntry);
+    }
+    return bytes;
+}
+
+std::string LinearPageTable::getName() const {
+    return "linear";
+}
+
+// Radix
+
+RadixPageTable::RadixPageTable(int levels) : levels(levels) {}
+
+void RadixPageTable::initialize(int /*numFrames*/) {
+    roots.clear();
+    directories.clear();
+    leaves.clear();
+    freeDirectories.clear();
+    freeLeaves.clear();
+}
+
+void RadixPageTable::addProcess(int pid, int numPages) {
+    int topShift = NODE_BITS * (levels - 1);
+    int topEntries = numPages > 0 ? ((numPages - 1) >> topShift) + 1 : 0;
+    roots[pid] = { numPages, std::vector<int>(topEntries, -1) };
+}
+
+int RadixPageTable::allocateDirectory() {
+    if (!freeDirectories.empty()) {
+        int node = freeDirectories.back();
+        freeDirectories.pop_back();
+        return node;
+    }
+
+    int node = static_cast<int>(directories.size() / NODE_SIZE);
+    directories.resize(directories.size() + NODE_SIZE, -1);
+    return node;
+}
+
+int RadixPageTable::allocateLeaf() {
+    if (!freeLeaves.empty()) {
+        int node = freeLeaves.back();
+        freeLeaves.pop_back();
+        return node;
+    }
+
+    int node = static_cast<int>(leaves.size() / NODE_SIZE);
+    leaves.resize(leaves.size() + NODE_SIZE, { -1, false });
+    return node;
+}
+
+PageTableEntry* RadixPageTable::findEntry(int pid, int pageNumber, bool create, int* steps) {
+    auto it = roots.find(pid);
+    if (it == roots.end() || pageNumber >= it->second.numPages) {
+        return nullptr;
+    }
+
+    // Top level lives with the process
+    ++*steps;
+    std::vector<int>& top = it->second.entries;
+    int topIndex = pageNumber >> (NODE_BITS * (levels - 1));
+    int node = top[topIndex];
+    if (node == -1) {
+        if (!create) {
+            return nullptr;
+        }
+        node = levels > 2 ? allocateDirectory() : allocateLeaf();
+        top[topIndex] = node;
+    }
+
+    // Middle levels
+    for (int level = levels - 2; level >= 1; --level) {
+        ++*steps;
+        size_t index = static_cast<size_t>(node) * NODE_SIZE + ((pageNumber >> (NODE_BITS * level)) & NODE_MASK);
+        int child = directories[index];
+        if (child == -1) {
+            if (!create) {
+                return nullptr;
+            }
+            child = level > 1 ? allocateDirectory() : allocateLeaf(); // may grow the pool, so index again below
+            directories[index] = child;
+        }
+        node = child;
+    }
+
+    ++*steps;
+    return &leaves[static_cast<size_t>(node) * NODE_SIZE + (pageNumber & NODE_MASK)];
+}
+
+void RadixPageTable::removeNode(int node, int level, const std::function<void(int)>& onResidentFrame) {
+    size_t first = static_cast<size_t>(node) * NODE_SIZE;
+    if (level == 0) {
+        for (size_t i = first; i < first + NODE_SIZE; ++i) {
+            if (leaves[i].frame != -1) {
+                onResidentFrame(leaves[i].frame);
+            }
+            leaves[i] = { -1, false };
+        }
+        freeLeaves.push_back(node);
+        return;
+    }
+
+    for (size_t i = first; i < first + NODE_SIZE; ++i) {
+        if (directories[i] != -1) {
+            removeNode(directories[i], level - 1, onResidentFrame);
+            directories[i] = -1;
+        }
+    }
+    freeDirectories.push_back(node);
+}
+
+void RadixPageTable::removeProcess(int pid, const std::function<void(int)>& onResidentFrame) {
+    auto it = roots.find(pid);
+    if (it == roots.end()) {
+        return;
+    }
+
+    for (int node : it->second.entries) {
+        if (node != -1) {
+            removeNode(node, levels - 2, onResidentFrame);
+        }
+    }
+    roots.erase(it);
+}
+
+int RadixPageTable::getNumPages(int pid) const {
+    auto it = roots.find(pid);
+    return it != roots.end() ? it->second.numPages : 0;
+}
+
+PageTableEntry RadixPageTable::walk(int pid, int pageNumber, int& steps) const {
+    // create is false, so the walk leaves the table untouched
+    const PageTableEntry* entry = const_cast<RadixPageTable*>(this)->findEntry(pid, pageNumber, false, &steps);
+    return entry ? *entry : PageTableEntry{ -1, false };
+}
+
+void RadixPageTable::map(int pid, int pageNumber, int frame) {
+    int steps = 0;
+    PageTableEntry* entry = findEntry(pid, pageNumber, true, &steps);
+    if (entry) {
+        entry->frame = frame;
+    }
+}
+
+void RadixPageTable::unmap(int pid, int pageNumber) {
+    int steps = 0;
+    PageTableEntry* entry = findEntry(pid, pageNumber, true, &steps); // a page can be swapped without ever being mapped (cloned processes)
+    if (entry) {
+        entry->frame = -1;
+        entry->swapped = true;
+    }
+}
+
+std::vector<int> RadixPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& entry : roots) {
+        processIDs.push_back(entry.first);
+    }
+    return processIDs;
+}
+
+size_t RadixPageTable::getFootprint() const {
+    size_t bytes = directories.capacity() * sizeof(int) + leaves.capacity() * sizeof(PageTableEntry)
+        + (freeDirectories.capacity() + freeLeaves.capacity()) * sizeof(int)
+        + roots.bucket_count() * sizeof(void*);
+    for (const auto& entry : roots) {
+        bytes += sizeof(entry) + HASH_NODE_OVERHEAD + entry.second.entries.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+std::string RadixPageTable::getName() const {
+    return "radix" + std::to_string(levels);
+}
+
+// Inverted
+
+void InvertedPageTable::initialize(int numFrames) {
+    size_t buckets = 1;
+    while (buckets < static_cast<size_t>(numFrames)) {
+        buckets <<= 1;
+    }
+
+    hashAnchor.assign(buckets, -1);
+    framePid.assign(numFrames, -1);
+    framePage.assign(numFrames, -1);
+    frameNext.assign(numFrames, -1);
+    processes.clear();
+}
+
+size_t InvertedPageTable::getBucket(int pid, int pageNumber) const {
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | static_cast<uint32_t>(pageNumber);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key & (hashAnchor.size() - 1));
+}
+
+int InvertedPageTable::findFrame(int pid, int pageNumber, int* steps) const {
+    ++*steps; // hash anchor
+    for (int frame = hashAnchor[getBucket(pid, pageNumber)]; frame != -1; frame = frameNext[frame]) {
+        ++*steps;
+        if (framePid[frame] == pid && framePage[frame] == pageNumber) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void InvertedPageTable::removeFrame(int frame) {
+    int* link = &hashAnchor[getBucket(framePid[frame], framePage[frame])];
+    while (*link != frame) {
+        link = &frameNext[*link];
+    }
+    *link = frameNext[frame];
+
+    framePid[frame] = -1;
+    framePage[frame] = -1;
+    frameNext[frame] = -1;
+}
+
+void InvertedPageTable::addProcess(int pid, int numPages) {
+    processes[pid] = { numPages, 0, std::vector<bool>(numPages, false) };
+}
+
+void InvertedPageTable::removeProcess(int pid, const std::function<void(int)>& onResidentFrame) {
+    auto it = processes.find(pid);
+    if (it == processes.end()) {
+        return;
+    }
+
+    // Look every page up instead of scanning all frames, stopping once nothing is resident
+    for (int page = 0; page < it->second.numPages && it->second.numResident > 0; ++page) {
+        int steps = 0;
+        int frame = findFrame(pid, page, &steps);
+        if (frame != -1) {
+            onResidentFrame(frame);
+            removeFrame(frame);
+            --it->second.numResident;
+        }
+    }
+    processes.erase(it);
+}
+
+int InvertedPageTable::getNumPages(int pid) const {
+    auto it = processes.find(pid);
+    return it != processes.end() ? it->second.numPages : 0;
+}
+
+PageTableEntry InvertedPageTable::walk(int pid, int pageNumber, int& steps) const {
+    auto it = processes.find(pid);
+    if (it == processes.end() || pageNumber >= it->second.numPages) {
+        return { -1, false };
+    }
+
+    int frame = findFrame(pid, pageNumber, &steps);
+    return { frame, static_cast<bool>(it->second.swapped[pageNumber]) };
+}
+
+void InvertedPageTable::map(int pid, int pageNumber, int frame) {
+    auto it = processes.find(pid);
+    if (it == processes.end()) {
+        return;
+    }
+
+    // the page may be moving to another frame (huge page promotion, copy-on-write)
+    int steps = 0;
+    int oldFrame = findFrame(pid, pageNumber, &steps);
+    if (oldFrame != -1) {
+        removeFrame(oldFrame);
+        --it->second.numResident;
+    }
+
+    size_t bucket = getBucket(pid, pageNumber);
+    framePid[frame] = pid;
+    framePage[frame] = pageNumber;
+    frameNext[frame] = hashAnchor[bucket];
+    hashAnchor[bucket] = frame;
+    ++it->second.numResident;
+}
+
+void InvertedPageTable::unmap(int pid, int pageNumber) {
+    auto it = processes.find(pid);
+    if (it == processes.end()) {
+        return;
+    }
+
+    int steps = 0;
+    int frame = findFrame(pid, pageNumber, &steps);
+    if (frame != -1) {
+        removeFrame(frame);
+        --it->second.numResident;
+    }
+    it->second.swapped[pageNumber] = true;
+}
+
+std::vector<int> InvertedPageTable::getProcessIDs() const {
+    std::vector<int> processIDs;
+    for (const auto& entry : processes) {
+        processIDs.push_back(entry.first);
+    }
+    return processIDs;
+}
+
+size_t InvertedPageTable::getFootprint() const {
+    size_t bytes = (hashAnchor.capacity() + framePid.capacity() + framePage.capacity() + frameNext.capacity()) * sizeof(int)
+        + processes.bucket_count() * sizeof(void*);
+    for (const auto& entry : processes) {
+        bytes += sizeof(entry) + HASH_NODE_OVERHEAD + (entry.second.swapped.size() + 7) / 8;
+    }
+    return bytes;
+}
+
+std::string InvertedPageTable::getName() const {
+    return "inverted";
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+// Page table entry (for paging alloc)
+struct PageTableEntry {
+	int frame;      // frame holding the page, -1 if not resident
+	bool swapped;   // page has been written to the backing store
+};
+
+// Maps (pid, page number) to frames for the paging allocator
+// The layouts trade host memory for lookup cost; every lookup counts the table accesses it needed
+class PageTable
+{
+public:
+	virtual ~PageTable() = default;
+
+	virtual void initialize(int numFrames) = 0;
+	virtual void addProcess(int pid, int numPages) = 0;	// every page starts out non-resident
+	virtual void removeProcess(int pid, const std::function<void(int)>& onResidentFrame) = 0; // calls back with each frame the process still holds
+	virtual int getNumPages(int pid) const = 0;	// 0 if the process has no page table
+	virtual void map(int pid, int pageNumber, int frame) = 0;	// page is now resident in the frame
+	virtual void unmap(int pid, int pageNumber) = 0;	// page was written to the backing store
+	virtual std::vector<int> getProcessIDs() const = 0;
+	virtual size_t getFootprint() const = 0;	// host memory used by the table, in bytes
+	virtual std::string getName() const = 0;
+	virtual bool canShareFrames() const { return true; } // false if a frame can only be mapped by one page
+
+	PageTableEntry lookup(int pid, int pageNumber);	// {-1, false} if the page was never touched
+	long long getNumLookups() const;
+	double getAverageLookupSteps() const;	// table accesses per lookup
+
+	static std::unique_ptr<PageTable> create(const std::string& name); // "linear", "radix2", "radix3" or "inverted"
+	static std::vector<std::string> getPageTableNames();
+
+protected:
+	virtual PageTableEntry walk(int pid, int pageNumber, int& steps) const = 0;
+
+private:
+	long long numLookups = 0;
+	long long numLookupSteps = 0;
+};
+
+// One array of entries per process, indexed by page number
+class LinearPageTable : public PageTable
+{
+public:
+	void initialize(int numFrames) override;
+	void addProcess(int pid, int numPages) override;
+	void removeProcess(int pid, const std::function<void(int)>& onResidentFrame) override;
+	int getNumPages(int pid) const override;
+	void map(int pid, int pageNumber, int frame) override;
+	void unmap(int pid, int pageNumber) override;
+	std::vector<int> getProcessIDs() const override;
+	size_t getFootprint() const override;
+	std::string getName() const override;
+
+protected:
+	PageTableEntry walk(int pid, int pageNumber, int& steps) const override;
+
+private:
+	std::unordered_map<int, std::vector<PageTableEntry>> processPageTable; // map of process id to its page table
+};
+
+// Multi-level table, 9 bits of the page number per level like x86-64
+// Directories and leaves are only created for the ranges a process has touched
+class RadixPageTable : public PageTable
+{
+public:
+	explicit RadixPageTable(int levels);
+
+	void initialize(int numFrames) override;
+	void addProcess(int pid, int numPages) override;
+	void removeProcess(int pid, const std::function<void(int)>& onResidentFrame) override;
+	int getNumPages(int pid) const override;
+	void map(int pid, int pageNumber, int frame) override;
+	void unmap(int pid, int pageNumber) override;
+	std::vector<int> getProcessIDs() const override;
+	size_t getFootprint() const override;
+	std::string getName() const override;
+
+protected:
+	PageTableEntry walk(int pid, int pageNumber, int& steps) const override;
+
+private:
+	struct ProcessRoot {
+		int numPages;
+		std::vector<int> entries; // top level, sized to cover the process
+	};
+
+	int levels;
+	std::unordered_map<int, ProcessRoot> roots;
+
+	// Node pools, a node is a contiguous slice of NODE_SIZE entries
+	std::vector<int> directories; // index of the next level node, -1 if none
+	std::vector<PageTableEntry> leaves;
+	std::vector<int> freeDirectories;
+	std::vector<int> freeLeaves;
+
+	int allocateDirectory();
+	int allocateLeaf();
+	PageTableEntry* findEntry(int pid, int pageNumber, bool create, int* steps);
+	void removeNode(int node, int level, const std::function<void(int)>& onResidentFrame);
+};
+
+// Frame-indexed table: one entry per frame, found by hashing (pid, page number)
+// Its size only depends on physical memory; which pages were swapped is kept in a bit per page
+class InvertedPageTable : public PageTable
+{
+public:
+	void initialize(int numFrames) override;
+	void addProcess(int pid, int numPages) override;
+	void removeProcess(int pid, const std::function<void(int)>& onResidentFrame) override;
+	int getNumPages(int pid) const override;
+	void map(int pid, int pageNumber, int frame) override;
+	void unmap(int pid, int pageNumber) override;
+	std::vector<int> getProcessIDs() const override;
+	size_t getFootprint() const override;
+	std::string getName() const override;
+	bool canShareFrames() const override { return false; }
+
+protected:
+	PageTableEntry walk(int pid, int pageNumber, int& steps) const override;
+
+private:
+	struct ProcessInfo {
+		int numPages;
+		int numResident;
+		std::vector<bool> swapped;
+	};
+
+	std::vector<int> hashAnchor; // first frame of each hash chain, -1 if empty
+	std::vector<int> framePid;
+	std::vector<int> framePage;
+	std::vector<int> frameNext; // next frame in the same hash chain
+	std::unordered_map<int, ProcessInfo> processes;
+
+	size_t getBucket(int pid, int pageNumber) const;
+	int findFrame(int pid, int pageNumber, int* steps) const;
+	void removeFrame(int frame);
+};
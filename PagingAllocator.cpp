@@ -1,148 +1,1074 @@
 #include "PagingAllocator.h"
 #include <iostream>
 #include <algorithm>
-#include <ctime>
 
-PagingAllocator::PagingAllocator() = default;
+namespace {
+    const size_t REFERENCE_TRACE_SIZE = 65536; // references kept for the offline policy comparison
+}
+
+PagingAllocator::PagingAllocator()
+    : configManager(nullptr), memorySize(0), pageSize(0), numPagesPagedIn(0), numPagesPagedOut(0), numResidentPages(0),
+      numPageReferences(0), numPageFaults(0), numMinorFaults(0), numMajorFaults(0),
+      numDirectReclaims(0), numBackgroundReclaims(0), hugePageFrames(0), numHugePages(0), numHugePagePromotions(0),
+      numHugePageDemotions(0), numHugePageFallbacks(0), numHugePagePagesCopied(0),
+      numSharedFrames(0), numSharedMappings(0), numSwapFullFailures(0), numCleanSwapOuts(0), numForks(0), numCopyOnWriteFaults(0), numSwapCacheHits(0), numSwapInPages(0),
+      maxReadaheadWindow(0), readaheadWindow(0), readaheadUseful(0), readaheadWasted(0), numReadaheadPages(0), numReadaheadClusters(0),
+      numReadaheadHits(0), numReadaheadWasted(0),
+      numaNodes(1), framesPerNode(0), interleavePages(false), migrateAfter(0), numLocalPlacements(0), numRemotePlacements(0),
+      numPageMigrations(0), referenceTraceNext(0) {}
 
 void PagingAllocator::initialize(ConfigurationManager* configManager) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
     this->configManager = configManager;
 
     memorySize = configManager->getMaxOverallMemory();
     pageSize = configManager->getMemoryPerFrame();
     int numFrames = memorySize / pageSize;
-    memory.resize(numFrames, -1); // Initialize all frames as free
+    memory.assign(numFrames, -1); // Initialize all frames as free
+    framePage.assign(numFrames, -1);
+    frameReferences.assign(numFrames, 0);
+    sharedFrameMappings.clear();
+    numSharedFrames = 0;
+    numSharedMappings = 0;
+    swapCache.clear();
+    frameSwapSlot.assign(numFrames, -1);
+    processResidentPages.clear();
+    processWorkingSets.clear();
+    numResidentPages = 0;
+
+    // swap-size 0 gives a swap area four times the size of memory
+    int swapSize = static_cast<int>(configManager->getSwapSize());
+    swapSpace.initialize(swapSize > 0 ? swapSize / pageSize : numFrames * 4);
+
+    // Readahead starts with the whole window and shrinks if the read-ahead pages go unused
+    maxReadaheadWindow = std::max(0, configManager->getSwapReadahead());
+    readaheadWindow = maxReadaheadWindow;
+    frameReadahead.assign(numFrames, false);
+    readaheadUseful = 0;
+    readaheadWasted = 0;
+
+    pageTable = PageTable::create(configManager->getPageTableType());
+    if (!pageTable) {
+        std::cerr << "Unknown page table " << configManager->getPageTableType() << ", using linear" << std::endl;
+        pageTable = PageTable::create("linear");
+    }
+    pageTable->initialize(numFrames);
+
+    freeFrames.resize(numFrames, true);
+
+    replacementPolicy = PageReplacementPolicy::create(configManager->getPageReplacementPolicy());
+    if (!replacementPolicy) {
+        std::cerr << "Unknown page replacement policy " << configManager->getPageReplacementPolicy() << ", using clock" << std::endl;
+        replacementPolicy = PageReplacementPolicy::create("clock");
+    }
+    replacementPolicy->initialize(numFrames);
+
+    // A huge page is a power-of-two number of base frames
+    hugePageFrames = 0;
+    int hugePageSize = static_cast<int>(configManager->getHugePageSize());
+    if (hugePageSize > 0) {
+        int frames = hugePageSize / pageSize;
+        if (hugePageSize % pageSize == 0 && frames > 1 && (frames & (frames - 1)) == 0 && frames <= numFrames) {
+            hugePageFrames = frames;
+        }
+        else {
+            std::cerr << "huge-page-size " << hugePageSize << " is not a power-of-two multiple of mem-per-frame, huge pages are off" << std::endl;
+        }
+    }
+    processHugePageRegions.clear();
+    hugeFrames.resize(numFrames, false);
+    numHugePages = 0;
+
+    // Every node gets a contiguous range of frames
+    numaNodes = std::max(1, std::min(configManager->getNUMANodes(), numFrames));
+    framesPerNode = numFrames / numaNodes;
+    interleavePages = configManager->getNUMAPlacement() == "interleave";
+    migrateAfter = configManager->getNUMAMigrateAfter();
+    frameRemoteNode.assign(numFrames, -1);
+    frameRemoteAccesses.assign(numFrames, 0);
+
+    referenceTrace.clear();
+    referenceTraceNext = 0;
+}
+
+void PagingAllocator::recordReference(int pid, int pageNumber, bool isFault) {
+    ++numPageReferences;
+    if (isFault) {
+        ++numPageFaults;
+    }
+
+    int64_t page = (static_cast<int64_t>(pid) << 32) | static_cast<uint32_t>(pageNumber);
+    if (referenceTrace.size() < REFERENCE_TRACE_SIZE) {
+        referenceTrace.push_back(page);
+    }
+    else {
+        referenceTrace[referenceTraceNext] = page;
+    }
+    referenceTraceNext = (referenceTraceNext + 1) % REFERENCE_TRACE_SIZE;
 }
 
-bool PagingAllocator::allocate(Process process, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
+bool PagingAllocator::allocate(Process process) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
     int pagesNeeded = static_cast<int>(std::ceil(process.getMemorySize() / static_cast<float>(pageSize)));
-    std::vector<int> allocatedFrames;
-
-    while (pagesNeeded > 0) {
-        int freeFrame = findFreeFrame();
-        if (freeFrame == -1) {
-            // No free frame found, swap out a random page
-            std::unordered_set<int> runningProcessIDs; // Obtain this from the running processes
-            int swappedOutProcessID = swapOutRandomPage(runningProcessIDs, swapOutCallback);
-
-            if (swappedOutProcessID == -1) {
-                // Rollback if not enough pages were found
-                for (int frame : allocatedFrames) {
-                    memory[frame] = -1; // Mark the allocated pages as free
-                }
-                return false;
+
+    // Demand paging: every page starts out non-resident and is faulted in on first touch
+    pageTable->addProcess(process.getID(), pagesNeeded);
+    processResidentPages[process.getID()] = 0;
+    processWorkingSets[process.getID()] = WorkingSet(configManager->getWorkingSetWindow(), pagesNeeded);
+
+    // Processes asking for huge pages get them for every full region, the tail stays in base pages
+    if (hugePageFrames > 0 && process.getPageSize() >= hugePageFrames * pageSize && pagesNeeded >= hugePageFrames) {
+        HugePageRegions& regions = processHugePageRegions[process.getID()];
+        regions.residentPages.assign(pagesNeeded / hugePageFrames, 0);
+        regions.isHuge.assign(pagesNeeded / hugePageFrames, false);
+    }
+    return true;
+}
+
+bool PagingAllocator::fork(int parentPid, Process child) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    int numPages = pageTable->getNumPages(parentPid);
+    if (numPages == 0 || !pageTable->canShareFrames()) {
+        return false; // the child gets its own pages
+    }
+
+    // Huge pages are split first so every base page can be copied on its own
+    auto regions = processHugePageRegions.find(parentPid);
+    if (regions != processHugePageRegions.end()) {
+        for (int region = 0; region < static_cast<int>(regions->second.isHuge.size()); ++region) {
+            if (regions->second.isHuge[region]) {
+                splitHugePage(pageTable->lookup(parentPid, region * hugePageFrames).frame);
             }
         }
-        else {
-            memory[freeFrame] = process.getID();
-            allocatedFrames.push_back(freeFrame);
-            ++numPagesPagedIn; // Increment the counter for pages paged in
-            --pagesNeeded;
+        processHugePageRegions.erase(parentPid);
+    }
+
+    int childPid = child.getID();
+    pageTable->addProcess(childPid, numPages);
+    processResidentPages[childPid] = 0;
+    processWorkingSets[childPid] = WorkingSet(configManager->getWorkingSetWindow(), numPages);
+
+    for (int page = 0; page < numPages; ++page) {
+        PageTableEntry entry = pageTable->lookup(parentPid, page);
+        if (entry.frame != -1) {
+            addFrameMapping(entry.frame, childPid, page);
+            if (pageEvictionCallback) {
+                pageEvictionCallback(parentPid, page); // the parent's writable translation is now read-only
+            }
+        }
+        else if (entry.swapped) {
+            // Both processes refer to the copy in the swap slot
+            int slot = swapSpace.find(parentPid, page);
+            if (slot != -1) {
+                swapSpace.reference(slot);
+                swapSpace.assign(childPid, page, slot);
+                pageTable->unmap(childPid, page);
+            }
         }
     }
 
-    processPageTable[process.getID()] = allocatedFrames;
+    ++numForks;
     return true;
 }
 
 void PagingAllocator::deallocate(int pid) {
-    auto it = processPageTable.find(pid);
-    if (it != processPageTable.end()) {
-        for (int frame : it->second) {
-            memory[frame] = -1; // Free the frame
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    releaseProcess(pid);
+}
+
+void PagingAllocator::deallocate(const std::vector<int>& pids) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    for (int pid : pids) {
+        releaseProcess(pid);
+    }
+}
+
+void PagingAllocator::releaseProcess(int pid) {
+    pageTable->removeProcess(pid, [this, pid](int frame) {
+        if (removeFrameMapping(frame, pid) > 0) {
+            return; // another process still maps the frame
+        }
+
+        uncacheFrame(frame);
+        retireReadahead(frame, false);
+        memory[frame] = -1; // Free the frame
+        framePage[frame] = -1;
+        freeFrames.set(frame);
+        if (hugeFrames.test(frame)) {
+            hugeFrames.clear(frame);
+            if (frame % hugePageFrames == 0) {
+                replacementPolicy->onPageRemoved(frame); // only the first frame of a huge page is tracked
+                --numHugePages;
+            }
         }
-        processPageTable.erase(it);
+        else {
+            replacementPolicy->onPageRemoved(frame);
+        }
+        --numResidentPages;
+        });
+    processResidentPages.erase(pid);
+
+    // Shared swap slots are only freed by the last process referring to them
+    for (int slot : swapSpace.removeProcess(pid)) {
+        releaseSwapSlot(slot);
+    }
+    processWorkingSets.erase(pid);
+    processHugePageRegions.erase(pid);
+}
+
+PageAccess PagingAllocator::accessPage(int pid, int address, bool isWrite, int node) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    int numPages = pageTable->getNumPages(pid);
+    if (numPages == 0) {
+        return { PageFaultType::None, -1, false, false }; // process has no memory in the allocator
     }
+
+    int frame = -1;
+    PageFaultType faultType = referencePage(pid, (address / pageSize) % numPages, isWrite, node, frame);
+    // A write whose copy-on-write found no free frame leaves the page shared, the next write has to fault again
+    return { faultType, frame != -1 ? getNUMANode(frame) : -1, frame != -1, frame != -1 && frameReferences[frame] == 1 };
 }
 
-int PagingAllocator::findFreeFrame() {
-    for (int i = 0; i < memory.size(); ++i) {
-        if (memory[i] == -1) {
-            return i;
+PageFaultType PagingAllocator::referencePage(int pid, int pageNumber, bool isWrite, int node, int& frame, bool prefetch) {
+    if (!prefetch) {
+        processWorkingSets[pid].reference(pageNumber);
+    }
+    PageTableEntry entry = pageTable->lookup(pid, pageNumber);
+    int placementNode = getPlacementNode(pid, pageNumber, node);
+
+    if (entry.frame != -1) {
+        frame = entry.frame;
+        if (prefetch) {
+            return PageFaultType::None; // already in
+        }
+        if (frameReadahead[frame]) {
+            retireReadahead(frame, true);
+        }
+        if (isWrite && frameReferences[frame] > 1) {
+            return copyOnWrite(pid, pageNumber, node, frame);
+        }
+
+        // A page that keeps being accessed from one other node moves there
+        if (numaNodes > 1 && migrateAfter > 0 && node >= 0 && getNUMANode(frame) != node) {
+            if (frameRemoteNode[frame] != node) {
+                frameRemoteNode[frame] = node;
+                frameRemoteAccesses[frame] = 0;
+            }
+            if (++frameRemoteAccesses[frame] >= migrateAfter && migratePage(pid, pageNumber, frame, node)) {
+                frame = pageTable->lookup(pid, pageNumber).frame;
+            }
+        }
+        else {
+            frameRemoteAccesses[frame] = 0;
+        }
+
+        if (isWrite && frameSwapSlot[frame] != -1) {
+            uncacheFrame(frame); // the frame no longer matches the copy in the slot
+        }
+
+        replacementPolicy->onPageAccessed(getPolicyFrame(frame));
+        recordReference(pid, pageNumber, false);
+        return PageFaultType::None;
+    }
+
+    // First touch of an empty huge page region faults in the whole region, its pages are never shared so none is in the swap cache
+    HugePageRegions* regions = getHugePageRegions(pid, pageNumber);
+    if (!prefetch && regions && regions->residentPages[pageNumber / hugePageFrames] == 0) {
+        PageFaultType faultType;
+        if (mapHugePage(pid, pageNumber, faultType, frame)) {
+            recordReference(pid, pageNumber, true);
+            return faultType;
         }
+        ++numHugePageFallbacks;
     }
-    return -1; // No free frame found
+
+    // Another process sharing the swapped page may have read it back already, map that frame instead of reading it again
+    int swapSlot = entry.swapped ? swapSpace.take(pid, pageNumber) : -1;
+    if (swapSlot != -1) {
+        auto cached = swapCache.find(swapSlot);
+        if (cached != swapCache.end()) {
+            frame = cached->second;
+            addFrameMapping(frame, pid, pageNumber);
+            releaseSwapSlot(swapSlot);
+            ++numSwapCacheHits;
+
+            if (isWrite) {
+                return copyOnWrite(pid, pageNumber, node, frame);
+            }
+            replacementPolicy->onPageAccessed(frame);
+            if (!prefetch) {
+                ++numMinorFaults;
+                recordReference(pid, pageNumber, true);
+            }
+            return PageFaultType::Minor;
+        }
+    }
+
+    // Page fault, find a frame for the page, evicting one if memory is full
+    frame = takeFreeFrame(placementNode, -1);
+    if (frame == -1) {
+        if (swapSlot != -1) {
+            swapSpace.assign(pid, pageNumber, swapSlot);
+        }
+        return PageFaultType::NoFrame; // no frames at all
+    }
+
+    memory[frame] = pid;
+    freeFrames.clear(frame);
+    frameReferences[frame] = 1;
+    framePage[frame] = pageNumber;
+    pageTable->map(pid, pageNumber, frame);
+    ++processResidentPages[pid];
+    ++numResidentPages;
+    replacementPolicy->onPageLoaded(frame);
+    recordPlacement(frame, node);
+    if (regions) {
+        ++regions->residentPages[pageNumber / hugePageFrames];
+    }
+
+    PageFaultType faultType = swapSlot != -1 ? PageFaultType::Major : PageFaultType::Minor;
+    if (faultType == PageFaultType::Major) {
+        if (!prefetch) {
+            ++numMajorFaults;
+        }
+        ++numPagesPagedIn; // only major faults and prefetches read the page back in
+        if (pageInCallback) {
+            pageInCallback(swapSlot, pid, pageNumber);
+        }
+
+        // The swap cache keeps its own reference, the slot stays until the page is written and other sharers find the frame
+        swapCache[swapSlot] = frame;
+        frameSwapSlot[frame] = swapSlot;
+        swapSpace.reference(swapSlot);
+        releaseSwapSlot(swapSlot);
+
+        if (!prefetch && readaheadWindow > 1) {
+            readAhead(pid, swapSlot, node);
+        }
+    }
+    else if (!prefetch) {
+        ++numMinorFaults;
+    }
+    if (!prefetch) {
+        recordReference(pid, pageNumber, true);
+    }
+    return faultType;
 }
 
-int PagingAllocator::swapOutRandomPage(const std::unordered_set<int>& runningProcessIDs, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
-    std::vector<int> swappableFrames;
-    for (int i = 0; i < memory.size(); ++i) {
-        if (memory[i] != -1 && runningProcessIDs.find(memory[i]) == runningProcessIDs.end()) {
-            swappableFrames.push_back(i);
+void PagingAllocator::recordTLBHits(int pid, const std::vector<int>& addresses) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    int numPages = pageTable->getNumPages(pid);
+    if (numPages == 0) {
+        return; // the process was released since
+    }
+
+    // A hit only sets the reference state, a page evicted in the meantime just counts in the working set
+    for (int address : addresses) {
+        int pageNumber = (address / pageSize) % numPages;
+        processWorkingSets[pid].reference(pageNumber);
+        int frame = pageTable->lookup(pid, pageNumber).frame;
+        if (frame != -1) {
+            replacementPolicy->onPageAccessed(getPolicyFrame(frame));
         }
+        recordReference(pid, pageNumber, false);
     }
+}
 
-    if (swappableFrames.empty()) {
-        return -1;
+void PagingAllocator::readAhead(int pid, int swapSlot, int node) {
+    // Pages evicted together sit in neighbouring slots, read the aligned cluster of slots around the fault
+    int window = readaheadWindow;
+    int firstSlot = swapSlot - swapSlot % window;
+    int endSlot = std::min(firstSlot + window, swapSpace.getNumSlots());
+
+    int pagesRead = 0;
+    for (int slot = firstSlot; slot < endSlot; ++slot) {
+        int page = slot != swapSlot ? swapSpace.getSlotPage(slot, pid) : -1;
+        if (page == -1) {
+            continue;
+        }
+
+        // readahead only fills free frames, it never evicts a page that is in use for one that may not be
+        if (findFreeFrame(getPlacementNode(pid, page, node)) == -1) {
+            break;
+        }
+        int frame = -1;
+        if (referencePage(pid, page, false, node, frame, true) == PageFaultType::Major) {
+            frameReadahead[frame] = true;
+            ++pagesRead;
+        }
     }
 
-    srand(static_cast<unsigned int>(time(nullptr)));
-    int frameToSwap = swappableFrames[rand() % swappableFrames.size()];
-    swapOutPage(frameToSwap, swapOutCallback);
-    return memory[frameToSwap];
+    if (pagesRead > 0) {
+        numReadaheadPages += pagesRead;
+        ++numReadaheadClusters;
+    }
 }
 
-// TODO: Test for possible issues
-void PagingAllocator::swapOutPage(int frame, std::function<void(std::shared_ptr<Process>)> swapOutCallback) {
-    int pid = memory[frame];
-    if (pid != -1) {
-        //std::cout << "Swapping out page of process " << pid << " from frame " << frame << std::endl;
-        memory[frame] = -1; // Mark frame as free
-        ++numPagesPagedOut;
+void PagingAllocator::retireReadahead(int frame, bool useful) {
+    if (!frameReadahead[frame]) {
+        return;
+    }
+    frameReadahead[frame] = false;
+    if (useful) {
+        ++numReadaheadHits;
+        ++readaheadUseful;
+    }
+    else {
+        ++numReadaheadWasted;
+        ++readaheadWasted;
+    }
+
+    // Adapt once the window has seen a couple of clusters: double it while three in four pages are used, halve it while fewer than one in four are
+    int outcomes = readaheadUseful + readaheadWasted;
+    if (outcomes < readaheadWindow * 2) {
+        return;
+    }
+    if (readaheadUseful * 4 >= outcomes * 3) {
+        readaheadWindow = std::min(readaheadWindow * 2, maxReadaheadWindow);
+    }
+    else if (readaheadUseful * 4 < outcomes) {
+        readaheadWindow = std::max(readaheadWindow / 2, std::min(2, maxReadaheadWindow)); // two slots keep measuring whether neighbours get used
+    }
+    readaheadUseful = 0;
+    readaheadWasted = 0;
+}
+
+void PagingAllocator::setPageEvictionCallback(std::function<void(int, int)> callback) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    pageEvictionCallback = callback;
+}
+
+void PagingAllocator::setSwapCallbacks(std::function<void(int, int, int)> newPageOutCallback, std::function<void(int, int, int)> newPageInCallback,
+    std::function<void(int)> newSlotFreeCallback) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    pageOutCallback = newPageOutCallback;
+    pageInCallback = newPageInCallback;
+    slotFreeCallback = newSlotFreeCallback;
+}
+
+int PagingAllocator::findFreeFrame(int node) {
+    if (numaNodes == 1) {
+        return freeFrames.findFirstSet(); // -1 if no free frame found
+    }
 
-        auto it = processPageTable.find(pid);
-        if (it != processPageTable.end()) {
-            // Retrieve the process details from a suitable source
-            std::string processName = "Process" + std::to_string(pid); // Example process name
-            int totalInstructions = 1000; // Example total instructions
-            float memorySize = it->second.size() * pageSize; // Calculate memory size from the number of pages
-            float processPageSize = static_cast<float>(pageSize); // Ensure it's a float
+    // fall back to the other nodes before anything is evicted
+    for (int i = 0; i < numaNodes; ++i) {
+        int frame = findFreeFrameOnNode((node + i) % numaNodes);
+        if (frame != -1) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+int PagingAllocator::findFreeFrameOnNode(int node) const {
+    int firstFrame = node * framesPerNode;
+    int endFrame = node == numaNodes - 1 ? static_cast<int>(memory.size()) : firstFrame + framesPerNode;
+    int frame = freeFrames.findFirstSetFrom(firstFrame);
+    return frame < endFrame ? frame : -1;
+}
+
+int PagingAllocator::getNUMANode(int frame) const {
+    return numaNodes == 1 ? 0 : std::min(frame / framesPerNode, numaNodes - 1);
+}
+
+int PagingAllocator::getPlacementNode(int pid, int pageNumber, int node) const {
+    if (numaNodes == 1) {
+        return 0;
+    }
+    if (interleavePages) {
+        return (pid + pageNumber) % numaNodes; // round robin, consecutive pages of a process land on different nodes
+    }
+    return std::max(node, 0); // first touch
+}
+
+void PagingAllocator::recordPlacement(int frame, int node) {
+    if (numaNodes == 1) {
+        return;
+    }
+    if (getNUMANode(frame) == node) {
+        ++numLocalPlacements;
+    }
+    else {
+        ++numRemotePlacements;
+    }
+    frameRemoteAccesses[frame] = 0;
+}
+
+bool PagingAllocator::migratePage(int pid, int pageNumber, int frame, int node) {
+    // Only private base pages move, and only into free memory, migration never evicts
+    if (frameReferences[frame] != 1 || hugeFrames.test(frame)) {
+        return false;
+    }
+    int newFrame = findFreeFrameOnNode(node);
+    if (newFrame == -1) {
+        return false;
+    }
+
+    replacementPolicy->onPageRemoved(frame);
+    uncacheFrame(frame);
+    memory[frame] = -1;
+    framePage[frame] = -1;
+    frameReferences[frame] = 0;
+    frameRemoteAccesses[frame] = 0;
+    freeFrames.set(frame);
+
+    memory[newFrame] = pid;
+    framePage[newFrame] = pageNumber;
+    frameReferences[newFrame] = 1;
+    frameRemoteAccesses[newFrame] = 0;
+    freeFrames.clear(newFrame);
+    pageTable->map(pid, pageNumber, newFrame);
+    replacementPolicy->onPageLoaded(newFrame);
 
-            auto swappedOutProcess = std::make_shared<Process>(processName, pid, totalInstructions, memorySize, processPageSize);
+    if (pageEvictionCallback) {
+        pageEvictionCallback(pid, pageNumber); // the page moved, no core may keep the old translation
+    }
+    ++numPageMigrations;
+    return true;
+}
 
-            if (swapOutCallback) {
-                swapOutCallback(swappedOutProcess);
+int PagingAllocator::getPolicyFrame(int frame) const {
+    return hugeFrames.test(frame) ? frame - frame % hugePageFrames : frame;
+}
+
+int PagingAllocator::takeFreeFrame(int node, int excludedFrame) {
+    int frame = findFreeFrame(node);
+    if (frame == -1 && numaNodes > 1) {
+        // evict on the node first so the page stays local
+        frame = replacementPolicy->selectVictim([this, node, excludedFrame](int victim) { return victim != excludedFrame && getNUMANode(victim) == node; });
+        if (frame != -1) {
+            if (!swapOutPage(frame)) {
+                return -1;
             }
+            ++numDirectReclaims;
+            return frame;
+        }
+    }
+    if (frame == -1) {
+        frame = replacementPolicy->selectVictim([excludedFrame](int victim) { return victim != excludedFrame; });
+        if (frame == -1 || !swapOutPage(frame)) { // frees the frame, the faulting process waits for it
+            return -1;
+        }
+        ++numDirectReclaims;
+    }
+    return frame;
+}
+
+void PagingAllocator::addFrameMapping(int frame, int pid, int pageNumber) {
+    if (frameReferences[frame] == 1) {
+        sharedFrameMappings[frame] = { { memory[frame], framePage[frame] } };
+        ++numSharedFrames;
+    }
+    sharedFrameMappings[frame].push_back({ pid, pageNumber });
+    ++frameReferences[frame];
+    ++numSharedMappings;
+
+    pageTable->map(pid, pageNumber, frame);
+    ++processResidentPages[pid];
+}
+
+int PagingAllocator::removeFrameMapping(int frame, int pid) {
+    if (frameReferences[frame] <= 1) {
+        frameReferences[frame] = 0;
+        return 0;
+    }
+
+    // memory and framePage always hold one of the mappings that are left
+    std::vector<std::pair<int, int>>& mappings = sharedFrameMappings[frame];
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        if (mappings[i].first == pid) {
+            mappings.erase(mappings.begin() + i);
+            break;
+        }
+    }
+    memory[frame] = mappings[0].first;
+    framePage[frame] = mappings[0].second;
+    --frameReferences[frame];
+    --numSharedMappings;
+
+    if (frameReferences[frame] == 1) {
+        sharedFrameMappings.erase(frame);
+        --numSharedFrames;
+    }
+    return frameReferences[frame];
+}
+
+PageFaultType PagingAllocator::copyOnWrite(int pid, int pageNumber, int node, int& frame) {
+    int sharedFrame = frame;
+    int copyFrame = takeFreeFrame(getPlacementNode(pid, pageNumber, node), sharedFrame);
+    if (copyFrame == -1) {
+        return PageFaultType::None; // nowhere to copy to, the page stays shared
+    }
+    frame = copyFrame;
+
+    removeFrameMapping(sharedFrame, pid);
+    memory[frame] = pid;
+    freeFrames.clear(frame);
+    frameReferences[frame] = 1;
+    framePage[frame] = pageNumber;
+    pageTable->map(pid, pageNumber, frame);
+    ++numResidentPages;
+    replacementPolicy->onPageLoaded(frame);
+    recordPlacement(frame, node);
+
+    if (pageEvictionCallback) {
+        pageEvictionCallback(pid, pageNumber); // drop the read-only translation of the shared frame
+    }
+
+    ++numCopyOnWriteFaults;
+    recordReference(pid, pageNumber, true);
+    return PageFaultType::CopyOnWrite;
+}
+
+void PagingAllocator::releaseSwapSlot(int slot) {
+    if (!swapSpace.release(slot)) {
+        return;
+    }
+
+    // Last reference, the page leaves the swap area
+    auto cached = swapCache.find(slot);
+    if (cached != swapCache.end()) {
+        frameSwapSlot[cached->second] = -1;
+        swapCache.erase(cached);
+    }
+    if (slotFreeCallback) {
+        slotFreeCallback(slot);
+    }
+}
+
+void PagingAllocator::uncacheFrame(int frame) {
+    int slot = frameSwapSlot[frame];
+    if (slot != -1) {
+        swapCache.erase(slot);
+        frameSwapSlot[frame] = -1;
+        releaseSwapSlot(slot); // the swap cache's reference
+    }
+}
+
+bool PagingAllocator::dropSwapCacheSlot() {
+    for (const auto& cached : swapCache) {
+        if (swapSpace.getReferences(cached.first) == 1) {
+            uncacheFrame(cached.second); // only the cache holds the slot, the page is written again on its next eviction
+            return true;
+        }
+    }
+    return false;
+}
+
+PagingAllocator::HugePageRegions* PagingAllocator::getHugePageRegions(int pid, int pageNumber) {
+    if (hugePageFrames == 0) {
+        return nullptr;
+    }
+
+    auto it = processHugePageRegions.find(pid);
+    if (it == processHugePageRegions.end() || pageNumber / hugePageFrames >= static_cast<int>(it->second.residentPages.size())) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool PagingAllocator::mapHugePage(int pid, int pageNumber, PageFaultType& faultType, int& frame) {
+    // Huge pages are only built from free frames, memory pressure falls back to base pages instead of evicting
+    int firstFrame = freeFrames.findAlignedRun(hugePageFrames);
+    if (firstFrame == -1) {
+        return false;
+    }
+
+    HugePageRegions& regions = processHugePageRegions[pid];
+    int region = pageNumber / hugePageFrames;
+    int firstPage = region * hugePageFrames;
+    bool readBack = false;
 
-            // Remove the page frame from the process's page table
-            processPageTable[pid].erase(std::remove(processPageTable[pid].begin(), processPageTable[pid].end(), frame), processPageTable[pid].end());
+    for (int i = 0; i < hugePageFrames; ++i) {
+        int page = firstPage + i;
+        int regionFrame = firstFrame + i;
 
-            // If the process has no more pages, remove it from the page table
-            if (processPageTable[pid].empty()) {
-                processPageTable.erase(pid);
+        // pages of the region that were swapped out are read back with it
+        int slot = swapSpace.take(pid, page);
+        if (slot != -1) {
+            readBack = true;
+            ++numPagesPagedIn;
+            if (pageInCallback) {
+                pageInCallback(slot, pid, page);
             }
+            releaseSwapSlot(slot);
         }
+
+        memory[regionFrame] = pid;
+        freeFrames.clear(regionFrame);
+        frameReferences[regionFrame] = 1;
+        hugeFrames.set(regionFrame);
+        framePage[regionFrame] = page;
+        pageTable->map(pid, page, regionFrame);
+    }
+
+    processResidentPages[pid] += hugePageFrames;
+    numResidentPages += hugePageFrames;
+    regions.residentPages[region] = hugePageFrames;
+    regions.isHuge[region] = true;
+    ++numHugePages;
+    replacementPolicy->onPageLoaded(firstFrame);
+    frame = firstFrame + pageNumber % hugePageFrames;
+
+    faultType = readBack ? PageFaultType::Major : PageFaultType::Minor;
+    if (readBack) {
+        ++numMajorFaults;
+    }
+    else {
+        ++numMinorFaults;
+    }
+    return true;
+}
+
+void PagingAllocator::splitHugePage(int frame) {
+    int firstFrame = frame - frame % hugePageFrames;
+    int pid = memory[firstFrame];
+
+    // The frames keep their pages, the replacement policy now tracks each of them
+    for (int i = 0; i < hugePageFrames; ++i) {
+        hugeFrames.clear(firstFrame + i);
+        if (i > 0) {
+            replacementPolicy->onPageLoaded(firstFrame + i);
+        }
+    }
+
+    HugePageRegions* regions = getHugePageRegions(pid, framePage[firstFrame]);
+    if (regions) {
+        regions->isHuge[framePage[firstFrame] / hugePageFrames] = false;
     }
+    --numHugePages;
+    ++numHugePageDemotions;
 }
 
-int PagingAllocator::getUsedMemory(std::vector<std::shared_ptr<Process>> processes) const {
-    int usedMemory = 0;
+int PagingAllocator::promoteHugePages(int maxPromotions) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    if (hugePageFrames == 0) {
+        return 0;
+    }
+
+    // khugepaged-like: collapse regions whose base pages are all resident
+    int promoted = 0;
+    std::vector<int> frames(hugePageFrames);
+    for (auto& entry : processHugePageRegions) {
+        int pid = entry.first;
+        HugePageRegions& regions = entry.second;
+
+        for (int region = 0; region < static_cast<int>(regions.isHuge.size()) && promoted < maxPromotions; ++region) {
+            if (regions.isHuge[region] || regions.residentPages[region] < hugePageFrames) {
+                continue;
+            }
+
+            int firstPage = region * hugePageFrames;
+            bool inPlace = true;
+            for (int i = 0; i < hugePageFrames; ++i) {
+                frames[i] = pageTable->lookup(pid, firstPage + i).frame;
+                inPlace = inPlace && frames[i] == frames[0] + i;
+            }
+            inPlace = inPlace && frames[0] % hugePageFrames == 0;
+
+            int firstFrame = frames[0];
+            if (!inPlace) {
+                // Copy the pages to a free aligned run, nothing to promote into if memory is too fragmented
+                firstFrame = freeFrames.findAlignedRun(hugePageFrames);
+                if (firstFrame == -1) {
+                    return promoted;
+                }
+
+                for (int i = 0; i < hugePageFrames; ++i) {
+                    int oldFrame = frames[i];
+                    int newFrame = firstFrame + i;
+                    replacementPolicy->onPageRemoved(oldFrame);
+                    uncacheFrame(oldFrame);
+                    frameReadahead[newFrame] = frameReadahead[oldFrame];
+                    frameReadahead[oldFrame] = false;
+                    memory[oldFrame] = -1;
+                    framePage[oldFrame] = -1;
+                    frameReferences[oldFrame] = 0;
+                    freeFrames.set(oldFrame);
+
+                    memory[newFrame] = pid;
+                    frameReferences[newFrame] = 1;
+                    framePage[newFrame] = firstPage + i;
+                    freeFrames.clear(newFrame);
+                    pageTable->map(pid, firstPage + i, newFrame);
+                    if (pageEvictionCallback) {
+                        pageEvictionCallback(pid, firstPage + i); // the page moved, no core may keep the old translation
+                    }
+                }
+                numHugePagePagesCopied += hugePageFrames;
+                replacementPolicy->onPageLoaded(firstFrame);
+            }
+            else {
+                for (int i = 1; i < hugePageFrames; ++i) {
+                    replacementPolicy->onPageRemoved(frames[i]);
+                }
+            }
+
+            for (int i = 0; i < hugePageFrames; ++i) {
+                hugeFrames.set(firstFrame + i);
+            }
+            regions.isHuge[region] = true;
+            ++numHugePages;
+            ++numHugePagePromotions;
+            ++promoted;
+        }
+    }
+    return promoted;
+}
 
-    for (const auto& process : processes) {
-        int pid = process->getID();
+int PagingAllocator::reclaimPages(int count) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
 
-        // Check if the process is in the page table
-        auto it = processPageTable.find(pid);
-        if (it != processPageTable.end()) {
-            // Add memory used by this process
-            usedMemory += static_cast<int>(it->second.size()) * pageSize;
+    int reclaimed = 0;
+    while (reclaimed < count) {
+        int frame = replacementPolicy->selectVictim([](int) { return true; });
+        if (frame == -1 || !swapOutPage(frame)) {
+            break;
+        }
+        ++reclaimed;
+    }
+
+    numBackgroundReclaims += reclaimed;
+    return reclaimed;
+}
+
+int PagingAllocator::swapOutVictimPage(const std::unordered_set<int>& runningProcessIDs) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    int frameToSwap = replacementPolicy->selectVictim([this, &runningProcessIDs](int frame) {
+        return runningProcessIDs.find(memory[frame]) == runningProcessIDs.end();
+        });
+
+    if (frameToSwap == -1) {
+        return -1;
+    }
+
+    int pid = memory[frameToSwap];
+    return swapOutPage(frameToSwap) ? pid : -1;
+}
+
+bool PagingAllocator::isResident(int pid) const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    auto residentPages = processResidentPages.find(pid);
+    return residentPages == processResidentPages.end() || residentPages->second > 0 || swapSpace.getNumProcessSlots(pid) == 0;
+}
+
+int PagingAllocator::swapInProcess(int pid, int node) {
+    std::vector<int> pages;
+    {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+
+        // Only the pages the process was using when it lost its memory, the rest can wait for a fault
+        auto workingSet = processWorkingSets.find(pid);
+        if (workingSet == processWorkingSets.end()) {
+            return 0;
+        }
+        for (int page : swapSpace.getProcessPages(pid)) {
+            if (workingSet->second.contains(page)) {
+                pages.push_back(page);
+            }
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+
+    // One page per lock hold, faulting cores get in between the reads
+    int pagesRead = 0;
+    for (int page : pages) {
+        std::lock_guard<std::mutex> lock(allocatorMutex);
+        if (pageTable->getNumPages(pid) == 0) {
+            break; // the process was deallocated meanwhile
+        }
+
+        int frame = -1;
+        if (referencePage(pid, page, false, node, frame, true) == PageFaultType::Major) {
+            ++numSwapInPages;
+            ++pagesRead;
+        }
+        else if (frame == -1) {
+            break; // no frame to read into
+        }
+    }
+    return pagesRead;
+}
+
+std::unordered_map<int, std::vector<std::pair<int, int>>> PagingAllocator::getResidentPages() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    std::unordered_map<int, std::vector<std::pair<int, int>>> pages;
+    for (int frame = 0; frame < static_cast<int>(memory.size()); ++frame) {
+        if (memory[frame] == -1) {
+            continue;
+        }
+
+        // a shared frame is resident in every process that maps it
+        auto shared = sharedFrameMappings.find(frame);
+        if (shared != sharedFrameMappings.end()) {
+            for (const auto& mapping : shared->second) {
+                pages[mapping.first].emplace_back(mapping.second, getNUMANode(frame));
+            }
         }
         else {
-            // Optional: Debug/logging for processes without allocated memory
-            std::cout << "Process ID " << pid << " has no allocated pages." << std::endl;
+            pages[memory[frame]].emplace_back(framePage[frame], getNUMANode(frame));
         }
     }
+    return pages;
+}
+
+int PagingAllocator::restorePages(int pid, const std::vector<std::pair<int, int>>& pages) {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    if (pageTable->getNumPages(pid) == 0) {
+        return 0;
+    }
 
-    return usedMemory;
+    // A clone restored after its parent already maps the shared pages, only its private ones are loaded
+    int pagesLoaded = 0;
+    for (const auto& page : pages) {
+        int frame = -1;
+        if (referencePage(pid, page.first, false, page.second, frame, true) != PageFaultType::None) {
+            ++pagesLoaded;
+        }
+        else if (frame == -1) {
+            break; // no frame to load into
+        }
+    }
+    return pagesLoaded;
 }
 
+bool PagingAllocator::swapOutPage(int frame) {
+    int pid = memory[frame];
+    if (pid == -1) {
+        return false;
+    }
 
-std::vector<int> PagingAllocator::getProcessKeys() const {
-    std::vector<int> processIDs;
-    for (const auto& entry : processPageTable) {
-        processIDs.push_back(entry.first);
+    // A page read back and not written since is still in its slot, it goes back to that slot without a write
+    int swapSlot = frameSwapSlot[frame];
+    if (swapSlot == -1 && swapSpace.getNumUsedSlots() == swapSpace.getNumSlots() && !dropSwapCacheSlot()) {
+        ++numSwapFullFailures;
+        return false;
+    }
+
+    if (hugeFrames.test(frame)) {
+        splitHugePage(frame); // huge pages are split on reclaim, only the victim base page is written out
+    }
+
+    // Every process mapping the frame loses it, a shared frame is still written out only once
+    std::vector<std::pair<int, int>> mappings = { { pid, framePage[frame] } };
+    auto shared = sharedFrameMappings.find(frame);
+    if (shared != sharedFrameMappings.end()) {
+        mappings = shared->second;
+        sharedFrameMappings.erase(shared);
+        --numSharedFrames;
+        numSharedMappings -= static_cast<int>(mappings.size()) - 1;
     }
-    return processIDs;
+
+    if (swapSlot != -1) {
+        swapCache.erase(swapSlot);
+        frameSwapSlot[frame] = -1;
+        for (size_t i = 0; i < mappings.size(); ++i) {
+            swapSpace.reference(swapSlot);
+        }
+        swapSpace.release(swapSlot); // the mappings took over the swap cache's reference
+        ++numCleanSwapOuts;
+    }
+    else {
+        swapSlot = swapSpace.allocate(static_cast<int>(mappings.size()));
+        if (pageOutCallback) {
+            pageOutCallback(swapSlot, pid, framePage[frame]);
+        }
+    }
+
+    retireReadahead(frame, false);
+    memory[frame] = -1; // Mark frame as free
+    freeFrames.set(frame);
+    frameReferences[frame] = 0;
+    framePage[frame] = -1;
+    replacementPolicy->onPageRemoved(frame);
+    ++numPagesPagedOut;
+    --numResidentPages;
+
+    // The page stays in the page tables, the next touch is a major fault that reads the slot
+    for (const auto& mapping : mappings) {
+        pageTable->unmap(mapping.first, mapping.second);
+        --processResidentPages[mapping.first];
+        HugePageRegions* regions = getHugePageRegions(mapping.first, mapping.second);
+        if (regions) {
+            --regions->residentPages[mapping.second / hugePageFrames];
+        }
+        swapSpace.assign(mapping.first, mapping.second, swapSlot);
+
+        if (pageEvictionCallback) {
+            pageEvictionCallback(mapping.first, mapping.second); // no core may keep translating to this frame
+        }
+    }
+    return true;
+}
+
+int PagingAllocator::getUsedMemory() const {
+    return numResidentPages * pageSize;
+}
+
+int PagingAllocator::getSwappedMemory() const {
+    return swapSpace.getNumUsedSlots() * pageSize;
+}
+
+int PagingAllocator::getSwapSize() const {
+    return swapSpace.getNumSlots() * pageSize;
+}
+
+int PagingAllocator::getNumSwappedPages(int pid) const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return swapSpace.getNumProcessSlots(pid);
+}
+
+long long PagingAllocator::getNumSwapFullFailures() const {
+    return numSwapFullFailures;
+}
+
+long long PagingAllocator::getNumSwapInPages() const {
+    return numSwapInPages;
+}
+
+int PagingAllocator::getReadaheadWindow() const {
+    return readaheadWindow;
+}
+
+long long PagingAllocator::getNumReadaheadPages() const {
+    return numReadaheadPages;
+}
+
+long long PagingAllocator::getNumReadaheadClusters() const {
+    return numReadaheadClusters;
+}
+
+long long PagingAllocator::getNumReadaheadHits() const {
+    return numReadaheadHits;
+}
+
+long long PagingAllocator::getNumReadaheadWasted() const {
+    return numReadaheadWasted;
+}
+
+long long PagingAllocator::getNumCleanSwapOuts() const {
+    return numCleanSwapOuts;
+}
+
+std::vector<int> PagingAllocator::getProcessKeys() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return pageTable->getProcessIDs();
+}
+
+int PagingAllocator::getNumFreeFrames() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return freeFrames.count();
 }
 
 int PagingAllocator::getNumPagesPagedIn() const {
@@ -152,3 +1078,155 @@ int PagingAllocator::getNumPagesPagedIn() const {
 int PagingAllocator::getNumPagesPagedOut() const {
     return numPagesPagedOut;
 }
+
+std::string PagingAllocator::getReplacementPolicyName() const {
+    return replacementPolicy ? replacementPolicy->getName() : "";
+}
+
+long long PagingAllocator::getNumPageReferences() const {
+    return numPageReferences;
+}
+
+long long PagingAllocator::getNumPageFaults() const {
+    return numPageFaults;
+}
+
+long long PagingAllocator::getNumMinorFaults() const {
+    return numMinorFaults;
+}
+
+long long PagingAllocator::getNumMajorFaults() const {
+    return numMajorFaults;
+}
+
+int PagingAllocator::getNumFrames() const {
+    return static_cast<int>(memory.size());
+}
+
+long long PagingAllocator::getNumDirectReclaims() const {
+    return numDirectReclaims;
+}
+
+long long PagingAllocator::getNumBackgroundReclaims() const {
+    return numBackgroundReclaims;
+}
+
+std::vector<int64_t> PagingAllocator::getReferenceTrace() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    // unroll the ring buffer so the oldest reference comes first
+    if (referenceTrace.size() < REFERENCE_TRACE_SIZE) {
+        return referenceTrace;
+    }
+
+    std::vector<int64_t> trace(referenceTrace.begin() + referenceTraceNext, referenceTrace.end());
+    trace.insert(trace.end(), referenceTrace.begin(), referenceTrace.begin() + referenceTraceNext);
+    return trace;
+}
+
+int PagingAllocator::getWorkingSetSize(int pid) const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    auto it = processWorkingSets.find(pid);
+    return it != processWorkingSets.end() ? it->second.getSize() : 0;
+}
+
+std::vector<std::pair<int, int>> PagingAllocator::getWorkingSetSizes() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    std::vector<std::pair<int, int>> sizes;
+    for (const auto& entry : processWorkingSets) {
+        sizes.push_back({ entry.first, entry.second.getSize() });
+    }
+    return sizes;
+}
+
+std::string PagingAllocator::getPageTableName() const {
+    return pageTable ? pageTable->getName() : "";
+}
+
+size_t PagingAllocator::getPageTableFootprint() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return pageTable ? pageTable->getFootprint() : 0;
+}
+
+double PagingAllocator::getAveragePageTableLookupSteps() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+    return pageTable ? pageTable->getAverageLookupSteps() : 0;
+}
+
+int PagingAllocator::getNumPageTableMappings() const {
+    return numResidentPages + numSharedMappings - numHugePages * (hugePageFrames - 1);
+}
+
+int PagingAllocator::getHugePageFrames() const {
+    return hugePageFrames;
+}
+
+int PagingAllocator::getNumHugePages() const {
+    return numHugePages;
+}
+
+long long PagingAllocator::getNumHugePagePromotions() const {
+    return numHugePagePromotions;
+}
+
+long long PagingAllocator::getNumHugePageDemotions() const {
+    return numHugePageDemotions;
+}
+
+long long PagingAllocator::getNumHugePageFallbacks() const {
+    return numHugePageFallbacks;
+}
+
+long long PagingAllocator::getNumHugePagePagesCopied() const {
+    return numHugePagePagesCopied;
+}
+
+long long PagingAllocator::getNumForks() const {
+    return numForks;
+}
+
+long long PagingAllocator::getNumCopyOnWriteFaults() const {
+    return numCopyOnWriteFaults;
+}
+
+long long PagingAllocator::getNumSwapCacheHits() const {
+    return numSwapCacheHits;
+}
+
+int PagingAllocator::getNumSharedFrames() const {
+    return numSharedFrames;
+}
+
+int PagingAllocator::getNumSharedMappings() const {
+    return numSharedMappings;
+}
+
+int PagingAllocator::getNumNUMANodes() const {
+    return numaNodes;
+}
+
+std::vector<int> PagingAllocator::getNUMANodeUsedFrames() const {
+    std::lock_guard<std::mutex> lock(allocatorMutex);
+
+    std::vector<int> usedFrames(numaNodes, 0);
+    for (int frame = 0; frame < static_cast<int>(memory.size()); ++frame) {
+        if (!freeFrames.test(frame)) {
+            ++usedFrames[getNUMANode(frame)];
+        }
+    }
+    return usedFrames;
+}
+
+long long PagingAllocator::getNumLocalPlacements() const {
+    return numLocalPlacements;
+}
+
+long long PagingAllocator::getNumRemotePlacements() const {
+    return numRemotePlacements;
+}
+
+long long PagingAllocator::getNumPageMigrations() const {
+    return numPageMigrations;
+}
@@ -5,36 +5,228 @@
 #include <memory>
 #include <functional>
 #include <unordered_set>
+#include <atomic>
+#include <mutex>
 #include "Process.h"
 #include "ConfigurationManager.h"
+#include "FrameBitmap.h"
+#include "PageReplacementPolicy.h"
+#include "PageTable.h"
+#include "WorkingSet.h"
+#include "SwapSpace.h"
 
+// Result of a memory reference (for demand paging)
+enum class PageFaultType {
+    None,   // page was resident
+    Minor,  // first touch, page is zero-filled without going to the backing store
+    Major,  // page was swapped out and has to be read back from the backing store
+    CopyOnWrite, // write to a frame shared with another process, the page is copied to a private frame
+    NoFrame // no frame could be freed for the page (the swap area is full), it is still not resident
+};
+
+struct PageAccess {
+    PageFaultType faultType;
+    int node; // NUMA node of the frame holding the page afterwards, -1 if the page could not be loaded
+    bool mapped; // the page has a frame now, a core may cache the translation
+    bool writable; // the frame is private to the process, a core may cache a writable translation
+};
+
+// Every public method takes the allocator's lock, so cores, the memory thread and vmstat can call it concurrently
 class PagingAllocator
 {
 public:
     PagingAllocator();
 
     void initialize(ConfigurationManager* configManager);
-    bool allocate(Process process, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    bool allocate(Process process); // create the page table, no page is loaded until it is touched
+    bool fork(int parentPid, Process child); // the child maps every page of the parent read-only, false if the parent's pages cannot be shared
     void deallocate(int pid);
+    void deallocate(const std::vector<int>& pids); // a batch of finished processes under one lock hold
+    PageAccess accessPage(int pid, int address, bool isWrite, int node); // reference an address from a core on the node, faulting the page in if needed
+    void recordTLBHits(int pid, const std::vector<int>& addresses); // references that hit a TLB, they reach the working set and the replacement policy late
 
-    int getUsedMemory(std::vector<std::shared_ptr<Process>> processes) const;
+    int getUsedMemory() const; // frames in use, a shared frame counts once; safe to call without the allocator lock
+    int getSwappedMemory() const; // swap slots in use, a shared page counts once; safe to call without the allocator lock
     std::vector<int> getProcessKeys() const;
-    int swapOutRandomPage(const std::unordered_set<int>& runningProcessIDs, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    void setPageEvictionCallback(std::function<void(int, int)> callback); // called with (pid, page number) when a page leaves memory
+    void setSwapCallbacks(std::function<void(int, int, int)> pageOutCallback, std::function<void(int, int, int)> pageInCallback,
+        std::function<void(int)> slotFreeCallback = nullptr); // called with (slot, pid, page number) to write a page to its swap slot and read it back, and with the slot once it is free
+    int reclaimPages(int count); // background eviction of up to count pages, returns the pages freed
+    int swapOutVictimPage(const std::unordered_set<int>& runningProcessIDs); // evict the frame picked by the replacement policy
+
+    // Swap-in of processes that lost all their resident pages
+    bool isResident(int pid) const; // false if none of the process's pages is in memory and some are in swap
+    int swapInProcess(int pid, int node); // reads back the swapped pages in the process's working set, returns the pages read
+    long long getNumSwapInPages() const; // pages read back by swapInProcess, not counted as faults
+
+    // Checkpoint, resident pages are loaded back without counting references; swapped pages come back on demand
+    std::unordered_map<int, std::vector<std::pair<int, int>>> getResidentPages() const; // pid -> (page number, NUMA node) of every resident page
+    int restorePages(int pid, const std::vector<std::pair<int, int>>& pages); // loads the pages, on their node if it has room, returns the pages loaded
 
+    // Swap readahead, a major fault also reads the neighbouring slots holding pages of the same process
+    int getReadaheadWindow() const; // slots per readahead cluster, 0 if readahead is off
+    long long getNumReadaheadPages() const; // pages read ahead of a fault, not counted as faults
+    long long getNumReadaheadClusters() const; // major faults that read at least one page ahead
+    long long getNumReadaheadHits() const; // read-ahead pages referenced before they left memory
+    long long getNumReadaheadWasted() const; // read-ahead pages evicted or freed without being referenced
+
+    int getNumFreeFrames() const;
+    int getSwapSize() const; // KB of swap area
+    int getNumSwappedPages(int pid) const; // pages of the process that are only in swap
+    long long getNumSwapFullFailures() const; // evictions that found no free swap slot
+    long long getNumCleanSwapOuts() const; // evictions of pages still in their swap slot, nothing had to be written
     int getNumPagesPagedIn() const;
     int getNumPagesPagedOut() const;
 
+    // Page replacement stats
+    std::string getReplacementPolicyName() const;
+    long long getNumPageReferences() const;
+    long long getNumPageFaults() const;
+    long long getNumMinorFaults() const;
+    long long getNumMajorFaults() const;
+    int getNumFrames() const;
+    long long getNumDirectReclaims() const; // faults that found no free frame and had to evict first
+    long long getNumBackgroundReclaims() const; // pages evicted by reclaimPages
+    std::vector<int64_t> getReferenceTrace() const; // most recent page references, oldest first
+
+    // Working sets
+    int getWorkingSetSize(int pid) const; // pages the process referenced within the working set window
+    std::vector<std::pair<int, int>> getWorkingSetSizes() const; // (pid, pages) of every process
+
+    // Page table stats
+    std::string getPageTableName() const;
+    size_t getPageTableFootprint() const; // host bytes used by the page tables
+    double getAveragePageTableLookupSteps() const;
+    int getNumPageTableMappings() const; // resident translations, a huge page needs one instead of one per base page
+
+    // Huge pages, aligned runs of base frames mapped as one page
+    int promoteHugePages(int maxPromotions); // collapse fully resident regions into huge pages, returns the promotions done
+    int getHugePageFrames() const; // base frames per huge page, 0 if huge pages are off
+    int getNumHugePages() const;
+    long long getNumHugePagePromotions() const;
+    long long getNumHugePageDemotions() const;
+    long long getNumHugePageFallbacks() const; // huge page faults that found no free aligned run and used a base frame
+    long long getNumHugePagePagesCopied() const; // base pages moved to an aligned run by promotion
+
+    // Copy-on-write sharing between cloned processes
+    long long getNumForks() const;
+    long long getNumCopyOnWriteFaults() const;
+    long long getNumSwapCacheHits() const; // faults on a shared swapped page that another process had already read back
+    int getNumSharedFrames() const; // frames mapped by more than one process
+    int getNumSharedMappings() const; // mappings beyond the first one of each frame, the pages sharing saves
+
+    // NUMA, the frames are split into one contiguous range per node
+    int getNumNUMANodes() const;
+    int getNUMANode(int frame) const;
+    std::vector<int> getNUMANodeUsedFrames() const; // frames in use on each node
+    long long getNumLocalPlacements() const; // faults that got a frame on the faulting core's node
+    long long getNumRemotePlacements() const; // faults placed on another node by interleaving or because the local node was full
+    long long getNumPageMigrations() const; // pages moved to the node that kept accessing them
 
 private:
     ConfigurationManager* configManager;
     int memorySize;
     int pageSize;
-    int numPagesPagedIn;
-    int numPagesPagedOut;
+    std::atomic<int> numPagesPagedIn;
+    std::atomic<int> numPagesPagedOut;
+    mutable std::mutex allocatorMutex;
+
+    std::vector<int> memory; // memory represented as page frames, holds the owner pid
+    std::vector<int> framePage; // page number held by each frame
+    std::unique_ptr<PageTable> pageTable; // layout picked by page-table in the config
+    std::unordered_map<int, int> processResidentPages; // map of process id to number of resident pages
+    std::atomic<int> numResidentPages;
+    std::unordered_map<int, WorkingSet> processWorkingSets; // map of process id to its working set
+
+    FrameBitmap freeFrames; // set bit = free frame
+    std::unique_ptr<PageReplacementPolicy> replacementPolicy; // only tracks frames that can be evicted
+    std::function<void(int, int)> pageEvictionCallback; // TLB shootdown
+
+    std::atomic<long long> numPageReferences;
+    std::atomic<long long> numPageFaults;
+    std::atomic<long long> numMinorFaults;
+    std::atomic<long long> numMajorFaults;
+    std::atomic<long long> numDirectReclaims;
+    std::atomic<long long> numBackgroundReclaims;
+
+    // Huge page regions of a process, only kept for processes whose page size reaches huge-page-size
+    struct HugePageRegions {
+        std::vector<int> residentPages; // resident base pages per region
+        std::vector<bool> isHuge; // region is mapped by one huge page
+    };
+
+    int hugePageFrames; // base frames per huge page, 0 if huge pages are off
+    std::unordered_map<int, HugePageRegions> processHugePageRegions;
+    FrameBitmap hugeFrames; // set bit = frame belongs to a huge page, only its first frame is known to the replacement policy
+    std::atomic<int> numHugePages;
+    std::atomic<long long> numHugePagePromotions;
+    std::atomic<long long> numHugePageDemotions;
+    std::atomic<long long> numHugePageFallbacks;
+    std::atomic<long long> numHugePagePagesCopied;
+
+    // Frames shared by cloned processes are read-only, the first write copies the page
+    std::vector<int> frameReferences; // page table mappings of each frame
+    std::unordered_map<int, std::vector<std::pair<int, int>>> sharedFrameMappings; // frame -> every (pid, page number) mapping it, only for shared frames
+    std::atomic<int> numSharedFrames;
+    std::atomic<int> numSharedMappings;
+
+    // Every swapped out page has a slot in the swap area, a shared page is written once and every process mapping it refers to the slot
+    SwapSpace swapSpace;
+    std::function<void(int, int, int)> pageOutCallback;
+    std::function<void(int, int, int)> pageInCallback;
+    std::function<void(int)> slotFreeCallback;
+    std::unordered_map<int, int> swapCache; // slot -> frame it was read back into, holds a reference on the slot while the frame is unchanged
+    std::vector<int> frameSwapSlot; // slot cached in each frame, -1 if none
+    std::atomic<long long> numSwapFullFailures;
+    std::atomic<long long> numCleanSwapOuts;
+    std::atomic<long long> numForks;
+    std::atomic<long long> numCopyOnWriteFaults;
+    std::atomic<long long> numSwapCacheHits;
+    std::atomic<long long> numSwapInPages;
+
+    int maxReadaheadWindow; // swap-readahead, 0 disables readahead
+    std::atomic<int> readaheadWindow; // halved while most read-ahead pages go unused, doubled back while most are used
+    std::vector<bool> frameReadahead; // frame holds a read-ahead page that was not referenced yet
+    int readaheadUseful; // outcomes since the window last changed
+    int readaheadWasted;
+    std::atomic<long long> numReadaheadPages;
+    std::atomic<long long> numReadaheadClusters;
+    std::atomic<long long> numReadaheadHits;
+    std::atomic<long long> numReadaheadWasted;
+
+    int numaNodes;
+    int framesPerNode; // the last node also gets the frames left over
+    bool interleavePages; // numa-placement interleave spreads pages over the nodes instead of placing them on the faulting core's node
+    int migrateAfter; // 0 disables migration
+    std::vector<int> frameRemoteNode; // node that accessed the frame remotely last
+    std::vector<int> frameRemoteAccesses; // remote accesses from frameRemoteNode in a row
+    std::atomic<long long> numLocalPlacements;
+    std::atomic<long long> numRemotePlacements;
+    std::atomic<long long> numPageMigrations;
 
-    std::vector<int> memory; // memory represented as page frames
-    std::unordered_map<int, std::vector<int>> processPageTable; // map of process id to page frames
+    std::vector<int64_t> referenceTrace; // ring buffer of (pid << 32 | page number)
+    size_t referenceTraceNext;
 
-    int findFreeFrame();
-    void swapOutPage(int frame, std::function<void(std::shared_ptr<Process>)> swapOutCallback);
+    PageFaultType referencePage(int pid, int pageNumber, bool isWrite, int node, int& frame, bool prefetch = false); // frame is set to the page's frame, -1 if it could not be loaded; a prefetch loads the page without counting a reference
+    int findFreeFrame(int node); // a free frame on the node, else on the next node that has one
+    int findFreeFrameOnNode(int node) const;
+    int getPlacementNode(int pid, int pageNumber, int node) const; // node a faulting page should go to
+    void recordPlacement(int frame, int node);
+    bool migratePage(int pid, int pageNumber, int frame, int node); // move a private page to a free frame on the node
+    int getPolicyFrame(int frame) const; // frame the replacement policy tracks, the first frame of a huge page
+    HugePageRegions* getHugePageRegions(int pid, int pageNumber); // nullptr if the page is not in a full huge page region
+    bool mapHugePage(int pid, int pageNumber, PageFaultType& faultType, int& frame); // fault in the whole region, false if there is no free aligned run
+    void splitHugePage(int frame); // demote a huge page back to base pages, the frames stay where they are
+    int takeFreeFrame(int node, int excludedFrame); // free frame, evicting anything but excludedFrame if needed, preferably on the node
+    void addFrameMapping(int frame, int pid, int pageNumber); // map a resident frame into one more process
+    int removeFrameMapping(int frame, int pid); // returns the mappings left on the frame
+    PageFaultType copyOnWrite(int pid, int pageNumber, int node, int& frame); // frame is the shared frame, set to the private copy placed for the accessing node
+    void releaseProcess(int pid); // frees the process's frames and swap slots, the allocator lock is held
+    void releaseSwapSlot(int slot); // drops a reference, the last one frees the slot
+    void uncacheFrame(int frame); // the frame is freed or written, drops the swap cache's reference on its slot
+    bool dropSwapCacheSlot(); // swap is full: frees a slot that only the swap cache still holds, false if there is none
+    void readAhead(int pid, int swapSlot, int node); // after a major fault on the slot, reads the rest of its cluster into free frames
+    void retireReadahead(int frame, bool useful); // the read-ahead page in the frame was referenced or is leaving memory, adapts the window
+    void recordReference(int pid, int pageNumber, bool isFault);
+    bool swapOutPage(int frame); // false if swap is full
 };
@@ -1,5 +1,6 @@
 #include "ResourceManager.h"
 #include "ConsoleManager.h"
+#include "EmulatorCheckpoint.h"
 
 #include <cstdlib>
 #include <ctime>
@@ -7,6 +8,26 @@
 #include <algorithm>
 #include <thread>
 #include <iomanip>
+#include <chrono>
+#include <unordered_map>
+
+namespace {
+	const int LOAD_CONTROL_RETRY_MS = 100; // how long admission waits before checking the fault rate again
+	const int ADMISSION_RETRY_MS = 100; // how long a process that found no memory waits if no memory is freed meanwhile
+
+	// One line of "bucket:count" pairs, empty buckets left out
+	void printHistogram(const std::string& title, const std::vector<long long>& histogram, std::string (*bucketName)(int)) {
+		std::cout << title;
+		bool empty = true;
+		for (int bucket = 0; bucket < static_cast<int>(histogram.size()); ++bucket) {
+			if (histogram[bucket] > 0) {
+				std::cout << " " << bucketName(bucket) << ":" << histogram[bucket];
+				empty = false;
+			}
+		}
+		std::cout << (empty ? " none\n" : "\n");
+	}
+}
 
 ResourceManager::ResourceManager(ConsoleManager& consoleManager)
 	: consoleManager(consoleManager), processCounter(0) {
@@ -16,6 +37,7 @@ ResourceManager::ResourceManager(ConsoleManager& consoleManager)
 
 ResourceManager::~ResourceManager() {
 	stopAllocationThread();
+	memoryManager.stop(); // the scheduler is destroyed first, its shootdowns and swap-in completions must be done by then
 }
 
 bool ResourceManager::initialize(ConfigurationManager* newConfigManager) {
@@ -23,6 +45,32 @@ bool ResourceManager::initialize(ConfigurationManager* newConfigManager) {
 
 	// Initialize the scheduler and memory manager
 	if (scheduler.initialize(configManager) && memoryManager.initialize(configManager, &scheduler)) {
+		// Every instruction a core runs goes through the memory manager (demand paging)
+		scheduler.setMemoryAccessCallback([this](std::shared_ptr<Process> process, int node) {
+			return memoryManager.accessMemory(process, node);
+			});
+		// TLB hits skip the memory manager, it still has to see them for page replacement and working sets
+		scheduler.setTLBHitCallback([this](std::shared_ptr<Process> process, const std::vector<int>& addresses) {
+			memoryManager.recordTLBHits(process, addresses);
+			});
+		// A process that lost its memory is swapped back in before a core runs it
+		scheduler.setSwapInCallback([this](std::shared_ptr<Process> process, int node) {
+			return memoryManager.swapIn(process, node);
+			});
+		// A finished process gives back its memory and swap space
+		scheduler.setProcessFinishedCallback([this](std::shared_ptr<Process> process) {
+			memoryManager.releaseProcess(process->getID());
+			});
+		// Processes waiting for memory retry as soon as some is freed
+		memoryManager.setMemoryFreedCallback([this]() {
+			{
+				std::lock_guard<std::mutex> lock(processMutex);
+				memoryFreed = true;
+			}
+			processAdded.notify_all();
+			});
+		admissionQueue.configure(configManager->getAdmissionOrder(), configManager->getAdmissionQueueDepth());
+
 		running = true;
 		startAllocationThread();
 		return true;
@@ -33,19 +81,46 @@ bool ResourceManager::initialize(ConfigurationManager* newConfigManager) {
 }
 
 std::shared_ptr<Process> ResourceManager::createProcess(std::string process_name) {
-	std::lock_guard<std::mutex> lock(processMutex);
+	std::unique_lock<std::mutex> lock(processMutex);
+	waitForAdmissionRoom(lock);
 
 	processCounter++;
 
 	// Generate random values for the process
 	int randomMaxInstructions = getRandomInt(configManager->getMinInstructions(), configManager->getMaxInstructions());
-	int pageSize = getRandomInt2N(configManager->getMemoryPerFrame());
+	// With huge pages on, a process asks for base pages, huge pages or a size in between
+	int pageSize = configManager->getHugePageSize() > 0
+		? getRandomInt2N(configManager->getHugePageSize(), configManager->getMemoryPerFrame())
+		: getRandomInt2N(configManager->getMemoryPerFrame());
 	int randomMemory = getRandomInt2N(configManager->getMaxMemoryPerProcess(), configManager->getMinMemoryPerProcess());
 
 
 	// Create a new process
 	auto newProcess = std::make_shared<Process>(process_name, processCounter, randomMaxInstructions, randomMemory, pageSize);
-	processes.push_back(newProcess);
+	admissionQueue.push(newProcess);
+	processesMasterList.push_back(newProcess);
+
+	// Notify the allocation thread
+	processAdded.notify_all();
+
+	return newProcess;
+}
+
+std::shared_ptr<Process> ResourceManager::forkProcess(const std::string parentName, const std::string process_name) {
+	std::unique_lock<std::mutex> lock(processMutex);
+
+	std::shared_ptr<Process> parent = findProcessByName(parentName);
+	if (!parent) {
+		return nullptr;
+	}
+	waitForAdmissionRoom(lock);
+
+	processCounter++;
+
+	// Same program and memory as the parent, the memory manager maps the parent's pages into it
+	auto newProcess = std::make_shared<Process>(process_name, processCounter, parent->getTotalInstructions(), parent->getMemorySize(), parent->getPageSize());
+	newProcess->setParentID(parent->getID());
+	admissionQueue.push(newProcess);
 	processesMasterList.push_back(newProcess);
 
 	// Notify the allocation thread
@@ -78,29 +153,61 @@ std::shared_ptr<Process> ResourceManager::findProcessByName(const std::string na
 
 void ResourceManager::allocateAndScheduleProcesses() {
 	while (running) {
-		std::unique_lock<std::mutex> lock(processMutex);
-		processAdded.wait(lock, [this] { return !running || !processes.empty(); }); // Wait until a process is added or the program is stopped
+		{
+			std::unique_lock<std::mutex> lock(processMutex);
+			processAdded.wait(lock, [this] { return !running || !admissionQueue.empty(); }); // Wait until a process is added or the program is stopped
 
-		if (!running) {
-			break;
+			if (!running) {
+				break;
+			}
+
+			// Load control: while memory is thrashing, new processes wait instead of adding to the fault load
+			if (configManager->getMemoryManagerAlgorithm() == "paging" && memoryManager.isThrashing()) {
+				++numDeferredAdmissions;
+				processAdded.wait_for(lock, std::chrono::milliseconds(LOAD_CONTROL_RETRY_MS));
+				continue;
+			}
 		}
 
-		auto process = processes.back(); // Get the last process added
-		processes.pop_back(); // Remove the process from the list
+		// A checkpoint waits until the process reaches the scheduler or is back in the queue
+		std::unique_lock<std::mutex> admissionLock(admissionMutex);
+		std::unique_lock<std::mutex> lock(processMutex);
+		if (admissionQueue.empty()) {
+			continue;
+		}
+		AdmissionQueue::Entry entry = admissionQueue.pop(); // Oldest or smallest process
+		memoryFreed = false;
 		lock.unlock(); // Unlock the mutex to allow other threads to add processes
 
 		// Try to allocate memory for the process
-		if (memoryManager.allocate(*process)) {
+		if (memoryManager.allocate(*entry.process)) {
 			// Add process to the scheduler if memory allocation is successful
-			scheduler.addProcess(process);
-		}
-		else {
-			std::lock_guard<std::mutex> lock(processMutex);
-			processes.erase(std::remove(processes.begin(), processes.end(), process), processes.end());
+			scheduler.addProcess(entry.process);
+			lock.lock();
+			admissionQueue.admitted(entry);
+			admissionRoom.notify_all();
+			continue;
 		}
+
+		// No memory for it, it keeps its place at the head and is retried once memory is freed
+		lock.lock();
+		admissionQueue.retry(entry);
+		admissionLock.unlock();
+		processAdded.wait_for(lock, std::chrono::milliseconds(ADMISSION_RETRY_MS), [this] { return !running || memoryFreed; });
 	}
 }
 
+void ResourceManager::waitForAdmissionRoom(std::unique_lock<std::mutex>& lock) {
+	if (!admissionQueue.isFull()) {
+		return;
+	}
+
+	admissionQueue.recordThrottle();
+	auto start = std::chrono::steady_clock::now();
+	admissionRoom.wait(lock, [this] { return !running || !admissionQueue.isFull(); });
+	admissionQueue.recordThrottleTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
 
 void ResourceManager::startAllocationThread() {
 	allocationThread = std::thread(&ResourceManager::allocateAndScheduleProcesses, this);
@@ -112,6 +219,7 @@ void ResourceManager::stopAllocationThread() {
 		running = false;
 	}
 	processAdded.notify_all();
+	admissionRoom.notify_all();
 	if (allocationThread.joinable()) {
 		allocationThread.join();
 	}
@@ -188,8 +296,7 @@ void ResourceManager::stopSchedulerTest() {
 void ResourceManager::schedulerTestLoop() {
 
 	while (schedulerTest) {
-		schedulerCounter++;
-		int processID = schedulerCounter;
+		int processID = ++schedulerCounter;
 		std::string processName = "process_test" + std::to_string(processID);
 		std::shared_ptr<Process> processPointer = createProcess(processName);
 		auto processScreen = std::make_shared<ProcessScreen>(processPointer);
@@ -218,6 +325,7 @@ void ResourceManager::displayStatus() {
 	std::cout << "CPU utilization: " << cpuUtilization << "%\n";
 	std::cout << "Cores used: " << coresUsed << "\n";
 	std::cout << "Cores available: " << totalCores - coresUsed << "\n";
+	std::cout << "Processes waiting for memory: " << admissionQueue.size() << "\n";
 	std::cout << "--------------------------------------------\n";
 
 	std::cout << "Running processes:\n";
@@ -267,11 +375,43 @@ void ResourceManager::displayProcessSmi() {
 	std::cout << "Running processes and memory usage: \n";
 	std::cout << "--------------------------------------------\n";
 
+	bool isPaging = configManager->getMemoryManagerAlgorithm() == "paging";
+	bool isNUMA = isPaging && memoryManager.pagingAllocator.getNumNUMANodes() > 1;
+	if (isPaging) {
+		std::cout << std::left << std::setw(20) << "Name" << std::setw(12) << "Memory" << std::setw(14) << "Working set"
+			<< std::setw(14) << "Minor faults" << std::setw(14) << "Major faults" << "Fault rate"
+			<< (isNUMA ? "  Remote" : "") << "   Wait ms\n";
+	}
+	else {
+		std::cout << std::left << std::setw(20) << "Name" << std::setw(30) << "Memory" << "Wait ms\n";
+	}
+
 	const std::vector<std::shared_ptr<Process>>& processes = scheduler.getProcesses();
 	for (const auto& process : processes) {
 		if (!process->isFinished() && process->getCore() != -1) {
-			std::cout << std::left << std::setw(20) << process->getName()
-				<< std::left << std::setw(30) << process->getMemorySize() << std::endl;
+			if (isPaging) {
+				long long references = process->getNumMemoryReferences();
+				long long faults = process->getNumMinorFaults() + process->getNumMajorFaults();
+				int workingSet = memoryManager.getWorkingSetSize(process->getID()) * static_cast<int>(configManager->getMemoryPerFrame());
+				std::cout << std::left << std::setw(20) << process->getName()
+					<< std::setw(12) << process->getMemorySize()
+					<< std::setw(14) << workingSet
+					<< std::setw(14) << process->getNumMinorFaults()
+					<< std::setw(14) << process->getNumMajorFaults()
+					<< std::right << std::fixed << std::setprecision(2) << std::setw(9) << (references ? faults * 100.0 / references : 0) << "%";
+				if (isNUMA) {
+					// share of the process's references that went to another node's memory
+					long long accesses = process->getNumLocalAccesses() + process->getNumRemoteAccesses();
+					std::cout << std::setw(7) << (accesses ? process->getNumRemoteAccesses() * 100.0 / accesses : 0) << "%";
+				}
+				// time spent waiting for swap-ins
+				std::cout << std::setw(10) << process->getWaitTime() / 1000.0 << std::defaultfloat << std::setprecision(6) << std::endl;
+			}
+			else {
+				std::cout << std::left << std::setw(20) << process->getName()
+					<< std::left << std::setw(30) << process->getMemorySize()
+					<< std::fixed << std::setprecision(2) << process->getWaitTime() / 1000.0 << std::defaultfloat << std::setprecision(6) << std::endl;
+			}
 		}
 	}
 	std::cout << "--------------------------------------------\n";
@@ -280,18 +420,214 @@ void ResourceManager::displayProcessSmi() {
 void ResourceManager::displayVMStat() {
 	std::vector<long long> stats = getCoreStats();
 	int usedMemory = memoryManager.getUsedMemory();
-	int freeMemory = configManager->getMaxOverallMemory() - usedMemory;
+	int freeMemory = memoryManager.getFreeMemory();
 	int pagedIn = memoryManager.pagingAllocator.getNumPagesPagedIn();
 	int pagedOut = memoryManager.pagingAllocator.getNumPagesPagedOut();
 
 	std::cout << configManager->getMaxOverallMemory() << " KB total memory\n";
 	std::cout << usedMemory << " KB used memory\n"; // Total used memory
 	std::cout << freeMemory << " KB free memory\n"; // Total free memory
+	std::cout << memoryManager.getActiveMemory() << " KB active memory\n"; // In RAM
+	std::cout << memoryManager.getInactiveMemory() << " KB inactive memory\n"; // Swapped out to the backing store
 	std::cout << stats[2] << " idle cpu ticks\n";
 	std::cout << stats[1] << " active cpu ticks\n";
 	std::cout << stats[0] << " total cpu ticks\n";
 	std::cout << pagedIn << " pages paged in\n";
 	std::cout << pagedOut << " pages paged out\n";
+	BackingStore* backingStore = memoryManager.getBackingStore();
+	std::cout << backingStore->getNumLiveRecords() << " processes in the backing store (" << backingStore->getNumRecords() << " records, "
+		<< backingStore->getFileSize() / 1024 << " KB file)\n";
+	std::cout << std::fixed << std::setprecision(2) << backingStore->getSpaceAmplification() << "x backing store space amplification, "
+		<< backingStore->getNumCompactions() << " compactions dropped " << backingStore->getNumRecordsReclaimed() << " dead records (last took "
+		<< backingStore->getLastCompactionTime() / 1000.0 << " ms, stores waited " << backingStore->getLastCompactionPause() << " us)\n"
+		<< std::defaultfloat << std::setprecision(6);
+
+	// Swap I/O, evictions queue their writes and the workers write them back in batches
+	SwapIOEngine* swapIO = memoryManager.getSwapIO();
+	std::cout << swapIO->getQueueDepth() << " swap I/O requests in flight (max " << swapIO->getMaxQueueDepth() << ", "
+		<< swapIO->getNumThreads() << " worker threads)\n";
+	std::cout << swapIO->getNumWriteBatches() << " swap write batches, " << swapIO->getNumBatchedWrites() << " writes batched, "
+		<< backingStore->getNumPageWrites() << " pages written in " << backingStore->getNumPageWriteRuns() << " runs\n";
+	std::cout << swapIO->getNumReadsFromQueue() << " swap reads answered from the write queue, "
+		<< swapIO->getNumThrottledWrites() << " writes waited for a full queue\n";
+	printHistogram("swap I/O queue depth:", swapIO->getDepthHistogram(), SwapIOEngine::getDepthBucketName);
+	printHistogram("swap write latency:  ", swapIO->getWriteLatencyHistogram(), SwapIOEngine::getLatencyBucketName);
+	printHistogram("swap read latency:   ", swapIO->getReadLatencyHistogram(), SwapIOEngine::getLatencyBucketName);
+	{
+		// Admission, creation to the scheduler
+		std::lock_guard<std::mutex> lock(processMutex);
+		std::cout << admissionQueue.getNumAdmitted() << " processes admitted in " << admissionQueue.getOrderName() << " order (average "
+			<< std::fixed << std::setprecision(2) << admissionQueue.getAverageLatency() / 1000.0 << " ms, max "
+			<< admissionQueue.getMaxLatency() / 1000.0 << " ms from creation to the scheduler)\n";
+		std::cout << admissionQueue.size() << " processes waiting for memory (peak " << admissionQueue.getPeakDepth();
+		if (admissionQueue.getMaxDepth() > 0) {
+			std::cout << " of " << admissionQueue.getMaxDepth();
+		}
+		std::cout << "), " << admissionQueue.getNumRejections() << " admission attempts found no memory, "
+			<< admissionQueue.getNumThrottled() << " creations waited for room (" << admissionQueue.getThrottleTime() / 1000.0 << " ms)\n"
+			<< std::defaultfloat << std::setprecision(6);
+	}
+	std::cout << memoryManager.getNumSwapIns() << " processes swapped in at dispatch (" << memoryManager.getNumFailedSwapIns()
+		<< " found no memory, " << memoryManager.getNumSwapInsInProgress() << " in progress)\n";
+	printHistogram("swap-in latency:     ", swapIO->getSwapInLatencyHistogram(), SwapIOEngine::getLatencyBucketName);
+	std::cout << memoryManager.getNumProcessesReleased() << " finished processes released in " << memoryManager.getNumReleaseBatches()
+		<< " batches (largest " << memoryManager.getLargestReleaseBatch() << ", average " << std::fixed << std::setprecision(2)
+		<< memoryManager.getAverageReleaseLatency() / 1000.0 << " ms, max " << memoryManager.getMaxReleaseLatency() / 1000.0
+		<< " ms from finish to memory freed)\n" << std::defaultfloat << std::setprecision(6);
+	printHistogram("release latency:     ", memoryManager.getReleaseLatencyHistogram(), SwapIOEngine::getLatencyBucketName);
+
+	if (configManager->getMemoryManagerAlgorithm() == "flat") {
+		std::cout << memoryManager.flatAllocator.getLargestFreeBlock() << " KB largest free block\n";
+		std::cout << std::fixed << std::setprecision(2) << memoryManager.flatAllocator.getExternalFragmentation()
+			<< "% external fragmentation\n" << std::defaultfloat << std::setprecision(6);
+		std::cout << memoryManager.getNumProcessesSwappedOut() << " processes swapped out\n";
+		std::cout << memoryManager.flatAllocator.getNumCompactions() << " compactions\n";
+		std::cout << memoryManager.flatAllocator.getNumBlocksMoved() << " blocks moved by compaction\n";
+		std::cout << memoryManager.flatAllocator.getMemoryMoved() << " KB moved by compaction\n";
+		std::cout << memoryManager.flatAllocator.getCompactionTime() << " us spent compacting\n";
+		if (memoryManager.flatAllocator.getNumShards() > 1) {
+			std::cout << memoryManager.flatAllocator.getNumShards() << " memory arenas: "
+				<< memoryManager.flatAllocator.getNumLocalAllocations() << " local, "
+				<< memoryManager.flatAllocator.getNumGlobalAllocations() << " global, "
+				<< memoryManager.flatAllocator.getNumStolenAllocations() << " stolen allocations\n";
+		}
+	}
+	else if (configManager->getMemoryManagerAlgorithm() == "buddy") {
+		std::cout << memoryManager.getLargestFreeBuddyBlock() << " KB largest free block\n";
+		std::cout << std::fixed << std::setprecision(2) << memoryManager.getBuddyInternalFragmentation()
+			<< "% internal fragmentation\n" << std::defaultfloat << std::setprecision(6);
+		std::cout << memoryManager.getNumProcessesSwappedOut() << " processes swapped out\n";
+	}
+	else if (configManager->getMemoryManagerAlgorithm() == "paging") {
+		PagingAllocator& pagingAllocator = memoryManager.pagingAllocator;
+		long long references = pagingAllocator.getNumPageReferences();
+		long long faults = pagingAllocator.getNumPageFaults();
+
+		std::cout << pagingAllocator.getReplacementPolicyName() << " page replacement\n";
+		long long minorFaults = pagingAllocator.getNumMinorFaults();
+		long long majorFaults = pagingAllocator.getNumMajorFaults();
+
+		std::cout << references << " page references\n";
+		std::cout << faults << " page faults\n";
+		std::cout << minorFaults << " minor page faults\n";
+		std::cout << majorFaults << " major page faults\n";
+		std::cout << std::fixed << std::setprecision(2) << (references ? faults * 100.0 / references : 0)
+			<< "% page fault rate\n";
+		std::cout << (references ? minorFaults * 100.0 / references : 0) << "% minor fault rate\n";
+		std::cout << (references ? majorFaults * 100.0 / references : 0) << "% major fault rate\n"
+			<< std::defaultfloat << std::setprecision(6);
+		std::cout << stats[3] << " cpu ticks blocked on page faults and remote memory\n";
+		std::cout << pagingAllocator.getNumFreeFrames() << " free frames (watermarks " << memoryManager.getLowWatermark()
+			<< " low, " << memoryManager.getHighWatermark() << " high)\n";
+		std::cout << pagingAllocator.getNumDirectReclaims() << " direct reclaim stalls\n";
+		std::cout << pagingAllocator.getNumBackgroundReclaims() << " pages reclaimed in the background ("
+			<< memoryManager.getNumReclaimWakeups() << " reclaim runs)\n";
+		std::cout << memoryManager.getTotalWorkingSetSize() << " pages in working sets (" << pagingAllocator.getNumFrames() << " frames)\n";
+		std::cout << std::fixed << std::setprecision(2) << memoryManager.getRecentFaultRate() << "% recent major fault rate"
+			<< std::defaultfloat << std::setprecision(6) << (memoryManager.isThrashing() ? ", thrashing\n" : "\n");
+		std::cout << numDeferredAdmissions << " admissions deferred by load control (" << LOAD_CONTROL_RETRY_MS << " ms each)\n";
+		std::cout << pagingAllocator.getPageTableName() << " page table, "
+			<< pagingAllocator.getPageTableFootprint() / 1024 << " KB host memory, " << std::fixed << std::setprecision(2)
+			<< pagingAllocator.getAveragePageTableLookupSteps() << " table accesses per lookup\n" << std::defaultfloat << std::setprecision(6);
+		std::cout << pagingAllocator.getNumPageTableMappings() << " page table mappings for " << pagingAllocator.getUsedMemory() / configManager->getMemoryPerFrame()
+			<< " resident pages\n";
+		if (pagingAllocator.getHugePageFrames() > 0) {
+			std::cout << pagingAllocator.getNumHugePages() << " huge pages of " << pagingAllocator.getHugePageFrames() << " frames ("
+				<< pagingAllocator.getNumHugePages() * pagingAllocator.getHugePageFrames() * configManager->getMemoryPerFrame() << " KB), "
+				<< pagingAllocator.getNumHugePageFallbacks() << " huge page faults fell back to base pages\n";
+			std::cout << pagingAllocator.getNumHugePagePromotions() << " huge page promotions (" << pagingAllocator.getNumHugePagePagesCopied()
+				<< " pages copied), " << pagingAllocator.getNumHugePageDemotions() << " demotions\n";
+		}
+		std::cout << pagingAllocator.getNumForks() << " processes cloned, " << pagingAllocator.getNumSharedFrames() << " shared frames ("
+			<< pagingAllocator.getNumSharedMappings() * configManager->getMemoryPerFrame() << " KB saved by sharing)\n";
+		std::cout << pagingAllocator.getNumCopyOnWriteFaults() << " copy-on-write faults, "
+			<< pagingAllocator.getNumSwapCacheHits() << " swap cache hits\n";
+		std::cout << pagingAllocator.getNumSwapInPages() << " pages read back by swap-ins\n";
+		if (configManager->getSwapReadahead() > 0) {
+			long long readaheadHits = pagingAllocator.getNumReadaheadHits();
+			long long readaheadWasted = pagingAllocator.getNumReadaheadWasted();
+			long long readaheadClusters = pagingAllocator.getNumReadaheadClusters();
+			std::cout << pagingAllocator.getNumReadaheadPages() << " pages read ahead in " << readaheadClusters << " clusters (avg "
+				<< std::fixed << std::setprecision(2) << (readaheadClusters ? 1 + pagingAllocator.getNumReadaheadPages() / static_cast<double>(readaheadClusters) : 0)
+				<< " pages per major fault), readahead window " << pagingAllocator.getReadaheadWindow() << " of " << configManager->getSwapReadahead() << " slots\n";
+			std::cout << readaheadHits << " read-ahead pages used, " << readaheadWasted << " wasted ("
+				<< (readaheadHits + readaheadWasted ? readaheadHits * 100.0 / (readaheadHits + readaheadWasted) : 0) << "% hit rate)\n"
+				<< std::defaultfloat << std::setprecision(6);
+		}
+		std::cout << pagingAllocator.getSwappedMemory() << " KB of " << pagingAllocator.getSwapSize() << " KB swap used, "
+			<< pagingAllocator.getNumSwapFullFailures() << " evictions failed on a full swap area\n";
+		std::cout << backingStore->getNumPageReads() << " swap slot reads, "
+			<< pagingAllocator.getNumCleanSwapOuts() << " clean pages evicted without a write\n";
+		if (backingStore->getNumPageReadErrors() > 0) {
+			std::cout << backingStore->getNumPageReadErrors() << " swap slots read back with the wrong page\n";
+		}
+
+		// Compressed swap pool, only the pages it writes back or cannot compress reach swap.bin
+		CompressedSwapPool* swapPool = memoryManager.getSwapPool();
+		if (swapPool->getCapacity() > 0) {
+			long long poolStores = swapPool->getNumStores();
+			long long fileWrites = swapPool->getNumWritebacks() + swapPool->getNumRejected();
+			long long poolHits = swapPool->getNumPoolHits();
+			long long swapReads = poolHits + swapPool->getNumFileReads();
+			std::cout << swapPool->getCompressedSize() / 1024 << " KB of " << swapPool->getCapacity() / 1024 << " KB compressed swap pool used by "
+				<< swapPool->getNumPages() << " pages (" << std::fixed << std::setprecision(2) << swapPool->getCompressionRatio() << ":1 compression)\n";
+			std::cout << poolStores << " pages stored in the pool, " << swapPool->getNumWritebacks() << " written back to swap.bin, "
+				<< swapPool->getNumRejected() << " did not compress, " << swapPool->getNumInvalidated() << " freed before reaching swap.bin\n";
+			std::cout << (poolStores ? (poolStores - fileWrites) * 100.0 / poolStores : 0) << "% fewer swap file writes\n";
+			std::cout << poolHits << " swap reads from the pool (" << (swapReads ? poolHits * 100.0 / swapReads : 0) << "%), "
+				<< swapPool->getNumFileReads() << " from swap.bin (" << (swapReads ? swapPool->getNumFileReads() * 100.0 / swapReads : 0) << "%)\n"
+				<< std::defaultfloat << std::setprecision(6);
+		}
+
+		// NUMA nodes, every core reaches its own node's frames faster than the others
+		if (pagingAllocator.getNumNUMANodes() > 1) {
+			std::vector<int> nodeUsedFrames = pagingAllocator.getNUMANodeUsedFrames();
+			std::cout << "NUMA nodes (" << configManager->getNUMAPlacement() << " placement, " << configManager->getNUMARemoteDelay()
+				<< " cycles per remote access):\n";
+			for (int node = 0; node < static_cast<int>(nodeUsedFrames.size()); ++node) {
+				std::cout << "  node " << node << ": " << nodeUsedFrames[node] * configManager->getMemoryPerFrame() << " KB used\n";
+			}
+
+			long long localAccesses = 0;
+			long long remoteAccesses = 0;
+			for (const auto& process : scheduler.getProcesses()) {
+				localAccesses += process->getNumLocalAccesses();
+				remoteAccesses += process->getNumRemoteAccesses();
+			}
+			long long accesses = localAccesses + remoteAccesses;
+			std::cout << std::fixed << std::setprecision(2) << (accesses ? localAccesses * 100.0 / accesses : 0) << "% local, "
+				<< (accesses ? remoteAccesses * 100.0 / accesses : 0) << "% remote memory accesses\n" << std::defaultfloat << std::setprecision(6);
+			std::cout << pagingAllocator.getNumLocalPlacements() << " pages placed locally, " << pagingAllocator.getNumRemotePlacements()
+				<< " remotely, " << pagingAllocator.getNumPageMigrations() << " migrated\n";
+		}
+
+		// Per-core TLBs, a hit skips the page table walk so only misses are counted as page references above
+		if (configManager->getTLBEntries() > 0) {
+			std::cout << "TLB per core (" << configManager->getTLBEntries() << " entries, " << configManager->getTLBWays() << "-way, "
+				<< (configManager->isTLBASIDTagged() ? "ASID tagged" : "flushed on context switch") << "):\n";
+			for (const auto& core : scheduler.getCoreWorkers()) {
+				std::vector<long long> tlbStats = core->getTLBStats();
+				long long lookups = tlbStats[0] + tlbStats[1];
+				std::cout << "  core " << std::left << std::setw(4) << core->getID() << std::right << std::fixed << std::setprecision(2)
+					<< std::setw(8) << (lookups ? tlbStats[0] * 100.0 / lookups : 0) << "% hit rate"
+					<< std::setw(10) << (tlbStats[3] ? tlbStats[1] * 1000.0 / tlbStats[3] : 0) << " MPKI"
+					<< std::setw(8) << tlbStats[2] << " flushes\n" << std::defaultfloat << std::setprecision(6);
+			}
+		}
+
+		// Replay the recent references with every policy, including the optimal one, to compare them
+		std::vector<int64_t> trace = memoryManager.getPageReferenceTrace();
+		if (!trace.empty()) {
+			std::cout << "Replacement policies on the last " << trace.size() << " references ("
+				<< pagingAllocator.getNumFrames() << " frames):\n";
+			for (const auto& policy : PageReplacementPolicy::getPolicyNames()) {
+				PageReplacementPolicy::SimulationResult result = PageReplacementPolicy::simulate(policy, trace, pagingAllocator.getNumFrames());
+				std::cout << "  " << std::left << std::setw(8) << policy << std::right
+					<< std::fixed << std::setprecision(2) << std::setw(8) << result.faults * 100.0 / result.references << "% faults"
+					<< std::setw(10) << result.evictions << " pages out\n" << std::defaultfloat << std::setprecision(6);
+			}
+		}
+	}
 }
 
 int ResourceManager::getCPUUtilization() {
@@ -321,15 +657,179 @@ std::vector<long long> ResourceManager::getCoreStats() {
 	long long cpuTicks = 0;
 	long long activeTicks = 0;
 	long long idleTicks = 0;
+	long long stallTicks = 0;
 
 	for (const auto& core : cores) {
 		std::vector<long long> stats = core->getStats();
 		cpuTicks += stats[0];
 		activeTicks += stats[1];
 		idleTicks += stats[2];
+		stallTicks += stats[3];
+	}
+
+	return { cpuTicks, activeTicks, idleTicks, stallTicks };
+}
+
+bool ResourceManager::checkpoint(const std::string& filename) {
+	auto start = std::chrono::steady_clock::now();
+	EmulatorCheckpoint::Contents contents;
+	contents.memoryManager = configManager->getMemoryManagerAlgorithm();
+	contents.scheduler = configManager->getSchedulerAlgorithm();
+	contents.numCPU = configManager->getNumCPU();
+	contents.maxOverallMemory = static_cast<int>(configManager->getMaxOverallMemory());
+	contents.memoryPerFrame = static_cast<int>(configManager->getMemoryPerFrame());
+	contents.schedulerCounter = schedulerCounter;
+
+	{
+		// No process is created or admitted meanwhile
+		std::lock_guard<std::mutex> admissionLock(admissionMutex);
+		std::lock_guard<std::mutex> lock(processMutex);
+
+		// Nothing is dispatched, every core stops between two instructions and every swap-in finishes back in the ready queue
+		scheduler.pause();
+		memoryManager.getSwapIO()->drain();
+
+		std::unordered_map<int, std::pair<EmulatorCheckpoint::Location, int>> locations; // pid -> where it is, position
+		std::vector<std::shared_ptr<Process>> waiting = admissionQueue.getProcesses();
+		for (int i = 0; i < static_cast<int>(waiting.size()); ++i) {
+			locations[waiting[i]->getID()] = std::make_pair(EmulatorCheckpoint::Location::Admission, i);
+		}
+		std::vector<std::shared_ptr<Process>> readyQueue = scheduler.getReadyQueue();
+		for (int i = 0; i < static_cast<int>(readyQueue.size()); ++i) {
+			locations[readyQueue[i]->getID()] = std::make_pair(EmulatorCheckpoint::Location::Ready, i);
+		}
+		for (const auto& core : scheduler.getCoreWorkers()) {
+			std::shared_ptr<Process> running = core->getCurrentProcess();
+			if (running) {
+				locations[running->getID()] = std::make_pair(EmulatorCheckpoint::Location::Running, core->getID());
+			}
+		}
+		for (const auto& process : scheduler.getProcesses()) {
+			if (locations.find(process->getID()) == locations.end()) {
+				// not queued and not on a core, so it is done
+				locations[process->getID()] = process->isFinished()
+					? std::make_pair(EmulatorCheckpoint::Location::Finished, 0)
+					: std::make_pair(EmulatorCheckpoint::Location::Ready, static_cast<int>(readyQueue.size()));
+			}
+		}
+
+		std::unordered_map<int, std::vector<std::pair<int, int>>> residentPages = memoryManager.getResidentPages();
+		contents.processCounter = processCounter;
+		for (const auto& process : processesMasterList) {
+			EmulatorCheckpoint::ProcessEntry entry;
+			entry.name = process->getName();
+			entry.state = process->getState();
+			entry.location = EmulatorCheckpoint::Location::NotAdmitted; // neither waiting nor scheduled, only listed
+			entry.position = 0;
+			auto location = locations.find(process->getID());
+			if (location != locations.end()) {
+				entry.location = location->second.first;
+				entry.position = location->second.second;
+			}
+			entry.swappedOut = memoryManager.isSwappedOut(process->getID());
+			auto pages = residentPages.find(process->getID());
+			if (pages != residentPages.end()) {
+				entry.residentPages.swap(pages->second);
+			}
+			contents.processes.push_back(std::move(entry));
+		}
+
+		scheduler.resume();
+	}
+
+	if (!EmulatorCheckpoint::save(filename, contents)) {
+		std::cout << "Cannot write " << filename << ".\n";
+		return false;
+	}
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	std::cout << contents.processes.size() << " processes checkpointed to " << filename << " ("
+		<< (EmulatorCheckpoint::getFileSize(contents) + 1023) / 1024 << " KB) in "
+		<< std::fixed << std::setprecision(2) << elapsed / 1000.0 << std::defaultfloat << std::setprecision(6) << " ms\n";
+	return true;
+}
+
+bool ResourceManager::restore(const std::string& filename) {
+	auto start = std::chrono::steady_clock::now();
+	EmulatorCheckpoint::Contents contents;
+	std::string error;
+	if (!EmulatorCheckpoint::load(filename, contents, error)) {
+		std::cout << error << "\n";
+		return false;
+	}
+
+	// Core IDs, queue positions and memory placement only mean the same thing under the same configuration
+	if (contents.memoryManager != configManager->getMemoryManagerAlgorithm() || contents.scheduler != configManager->getSchedulerAlgorithm()
+		|| contents.numCPU != configManager->getNumCPU() || contents.maxOverallMemory != static_cast<int>(configManager->getMaxOverallMemory())
+		|| contents.memoryPerFrame != static_cast<int>(configManager->getMemoryPerFrame())) {
+		std::cout << filename << " was taken with " << contents.numCPU << " CPUs, " << contents.scheduler << " scheduling and "
+			<< contents.maxOverallMemory << " KB of " << contents.memoryManager << " memory (" << contents.memoryPerFrame
+			<< " KB frames), initialize with the same configuration to restore it.\n";
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(processMutex);
+	if (!processesMasterList.empty()) {
+		std::cout << "Restore only works before any process is created, start the emulator again and restore first.\n";
+		return false;
+	}
+
+	scheduler.pause();
+	processCounter = contents.processCounter;
+	schedulerCounter = contents.schedulerCounter;
+
+	// Creation order, a clone's parent is back in memory before the clone maps its pages
+	std::vector<std::pair<int, std::shared_ptr<Process>>> readyQueue;
+	std::vector<std::pair<int, std::shared_ptr<Process>>> admission;
+	int numRunning = 0;
+	int numFinished = 0;
+	for (const auto& entry : contents.processes) {
+		auto process = std::make_shared<Process>(entry.name, entry.state);
+		processesMasterList.push_back(process);
+
+		if (entry.location == EmulatorCheckpoint::Location::Admission) {
+			admission.emplace_back(entry.position, process);
+		}
+		else if (entry.location != EmulatorCheckpoint::Location::NotAdmitted) {
+			// In the scheduler before its memory, a flat process that no longer fits may swap out one restored before it
+			// A finished process's memory was released, or about to be
+			bool isRunning = entry.location == EmulatorCheckpoint::Location::Running;
+			scheduler.restoreProcess(process, isRunning ? entry.position : 0);
+			if (entry.location != EmulatorCheckpoint::Location::Finished) {
+				memoryManager.restoreProcess(process, entry.swappedOut, entry.residentPages);
+			}
+
+			if (entry.location == EmulatorCheckpoint::Location::Ready) {
+				readyQueue.emplace_back(entry.position, process);
+			}
+			numRunning += isRunning ? 1 : 0;
+			numFinished += entry.location == EmulatorCheckpoint::Location::Finished ? 1 : 0;
+		}
+
+		consoleManager.addConsole(std::make_shared<ProcessScreen>(process));
+	}
+
+	std::stable_sort(readyQueue.begin(), readyQueue.end(),
+		[](const std::pair<int, std::shared_ptr<Process>>& a, const std::pair<int, std::shared_ptr<Process>>& b) { return a.first < b.first; });
+	for (const auto& queued : readyQueue) {
+		scheduler.resumeProcess(queued.second);
 	}
+	std::stable_sort(admission.begin(), admission.end(),
+		[](const std::pair<int, std::shared_ptr<Process>>& a, const std::pair<int, std::shared_ptr<Process>>& b) { return a.first < b.first; });
+	for (const auto& waiting : admission) {
+		admissionQueue.push(waiting.second);
+	}
+
+	scheduler.resume();
+	lock.unlock();
+	processAdded.notify_all();
 
-	return { cpuTicks, activeTicks, idleTicks };
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	std::cout << contents.processes.size() << " processes restored from " << filename << " in "
+		<< std::fixed << std::setprecision(2) << elapsed / 1000.0 << std::defaultfloat << std::setprecision(6) << " ms ("
+		<< numRunning << " running, " << readyQueue.size() << " ready, " << admission.size() << " waiting for memory, "
+		<< numFinished << " finished)\n";
+	return true;
 }
 
 void ResourceManager::saveReport() {
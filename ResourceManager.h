@@ -4,6 +4,7 @@
 #include "Scheduler.h"
 #include "ConfigurationManager.h"
 #include "Process.h"
+#include "AdmissionQueue.h"
 
 #include <vector>
 #include <memory>
@@ -24,6 +25,7 @@ public:
     bool initialize(ConfigurationManager* newConfigManager); // Initialize the scheduler and the memory manager
 
     std::shared_ptr<Process> createProcess(const std::string process_name);
+    std::shared_ptr<Process> forkProcess(const std::string parentName, const std::string process_name); // Clone of the parent that shares its pages copy-on-write, nullptr if the parent does not exist
     bool processExists(std::string name); // Check if a process with the given name exists
     std::shared_ptr<Process> findProcessByName(const std::string name); // Returns a process by its name
     void allocateAndScheduleProcesses(); // Allocate memory for processes and schedule them
@@ -44,6 +46,10 @@ public:
     // VM Stat
     void displayVMStat();
 
+    // Checkpoint and restore of the whole emulator
+    bool checkpoint(const std::string& filename);
+    bool restore(const std::string& filename); // only into an emulator that has no processes yet and the same configuration
+
     // Report-util
     void saveReport();
     void displayAllProcesses();
@@ -58,10 +64,14 @@ private:
     Scheduler scheduler;
 
     bool running;
-    std::vector<std::shared_ptr<Process>> processes;
+    AdmissionQueue admissionQueue; // processes waiting for memory, under processMutex
     std::vector<std::shared_ptr<Process>> processesMasterList;
     std::mutex processMutex;
-    std::condition_variable processAdded;
+    std::mutex admissionMutex; // held while a process is between the admission queue and the scheduler, taken before processMutex
+    std::condition_variable processAdded; // a process was added or memory was freed
+    std::condition_variable admissionRoom; // the admission queue has room again
+    bool memoryFreed = false; // since the last admission attempt, under processMutex
+    std::atomic<long long> numDeferredAdmissions{ 0 }; // admission checks held back while thrashing
 
     int processCounter;
     int getRandomInt(int min, int max); // Randomizer for the process details
@@ -70,9 +80,10 @@ private:
     std::thread allocationThread;
     void startAllocationThread();
     void stopAllocationThread();
+    void waitForAdmissionRoom(std::unique_lock<std::mutex>& lock); // backpressure on process creation, lock holds processMutex
 
     // Scheduler test
-    int schedulerCounter = 0;
+    std::atomic<int> schedulerCounter{ 0 }; // also read by checkpoint
     std::atomic<bool> schedulerTest{ false };
     std::thread testThread;
     std::mutex mtx;
@@ -65,14 +65,27 @@ void Scheduler::initializeCoreWorkers() {
     for (int i = 0; i < configManager->getNumCPU(); i++) {
         if (configManager->getSchedulerAlgorithm() == "rr") {
             cores.emplace_back(std::make_unique<CoreWorker>(i + 1, configManager->getDelayPerExec(), configManager->getQuantumCycles()));
-            cores.back()->start();
         }
 
         else {
             cores.emplace_back(std::make_unique<CoreWorker>(i + 1, configManager->getDelayPerExec()));
-            cores.back()->start();
         }
 
+        // Every core gets its own TLB in front of the page tables
+        if (configManager->getMemoryManagerAlgorithm() == "paging" && configManager->getTLBEntries() > 0) {
+            cores.back()->configureTLB(configManager->getTLBEntries(), configManager->getTLBWays(),
+                configManager->isTLBASIDTagged(), static_cast<int>(configManager->getMemoryPerFrame()));
+        }
+
+        // Consecutive cores share a NUMA node, like the sockets of a real machine
+        if (configManager->getMemoryManagerAlgorithm() == "paging" && configManager->getNUMANodes() > 1) {
+            cores.back()->configureNUMA(i * configManager->getNUMANodes() / configManager->getNumCPU(), configManager->getNUMARemoteDelay());
+        }
+        // Finished processes go to the memory manager, RR processes whose quantum ran out go back to the ready queue
+        cores.back()->setProcessCompletionCallback([this](std::shared_ptr<Process> process) {
+            onProcessCompletion(process);
+            });
+        cores.back()->start();
     }
 }
 
@@ -101,6 +114,80 @@ const std::vector<std::unique_ptr<CoreWorker>>& Scheduler::getCores() const {
     return cores;
 }
 
+void Scheduler::setMemoryAccessCallback(std::function<MemoryAccess(std::shared_ptr<Process>, int)> callback) {
+    for (auto& core : cores) {
+        core->setMemoryAccessCallback(callback);
+    }
+}
+
+void Scheduler::setTLBHitCallback(std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> callback) {
+    for (auto& core : cores) {
+        core->setTLBHitCallback(callback);
+    }
+}
+
+void Scheduler::invalidateTLBEntry(int pid, int pageNumber) {
+    for (auto& core : cores) {
+        core->invalidateTLBEntry(pid, pageNumber);
+    }
+}
+
+void Scheduler::setSwapInCallback(std::function<bool(std::shared_ptr<Process>, int)> callback) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    swapInCallback = callback;
+}
+
+void Scheduler::setProcessFinishedCallback(std::function<void(std::shared_ptr<Process>)> callback) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    processFinishedCallback = callback;
+}
+
+void Scheduler::onProcessCompletion(const std::shared_ptr<Process>& process) {
+    if (!process->isFinished()) {
+        std::lock_guard<std::mutex> queueLock(queueMutex);
+        readyQueue.push(process);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> processLock(processMutex);
+        finishedProcesses.push_back(process);
+    }
+    std::function<void(std::shared_ptr<Process>)> callback;
+    {
+        std::lock_guard<std::mutex> queueLock(queueMutex);
+        callback = processFinishedCallback;
+    }
+    if (callback) {
+        callback(process);
+    }
+}
+
+void Scheduler::resumeProcess(const std::shared_ptr<Process>& process) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    readyQueue.push(process);
+}
+
+bool Scheduler::isReadyToRun(const std::shared_ptr<Process>& process, int coreID) {
+    std::function<bool(std::shared_ptr<Process>, int)> callback;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        callback = swapInCallback;
+    }
+
+    // A process whose memory was swapped out waits for it off the ready queue, the core takes the next process instead
+    dispatchingProcessID = process->getID();
+    bool ready = !callback || callback(process, cores[coreID - 1]->getNUMANode());
+    if (!ready) {
+        dispatchingProcessID = -1;
+    }
+    return ready;
+}
+
+int Scheduler::getDispatchingProcessID() const {
+    return dispatchingProcessID;
+}
+
 int Scheduler::getAvailableCoreWorkerID() {
     for (auto& core : cores) {
         if (core->isAvailable()) {
@@ -112,7 +199,16 @@ int Scheduler::getAvailableCoreWorkerID() {
 
 void Scheduler::scheduleFCFS() {
     while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        if (dispatchPaused) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::lock_guard<std::mutex> dispatchLock(dispatchMutex);
+        if (dispatchPaused) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
         if (!readyQueue.empty()) {
 
             auto process = readyQueue.front();
@@ -121,8 +217,12 @@ void Scheduler::scheduleFCFS() {
             auto coreID = getAvailableCoreWorkerID();
 
             if (coreID > 0) {
-                process->setCore(coreID);
-                cores[coreID - 1]->setProcess(process);
+                // the swap-in may finish right away and requeue the process
+                lock.unlock();
+                if (!isReadyToRun(process, coreID)) {
+                    continue;
+                }
+                assignToCore(process, coreID);
             }
 
             else {
@@ -139,10 +239,25 @@ void Scheduler::scheduleFCFS() {
     }
 }
 
+void Scheduler::assignToCore(const std::shared_ptr<Process>& process, int coreID) {
+    process->setCore(coreID);
+    cores[coreID - 1]->setProcess(process);
+    dispatchingProcessID = -1; // the core now shows it as running
+}
+
 // TODO: implement RR scheduling
 void Scheduler::scheduleRR() {
     while (running) {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        if (dispatchPaused) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::lock_guard<std::mutex> dispatchLock(dispatchMutex);
+        if (dispatchPaused) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
         if (!readyQueue.empty()) {
             auto process = readyQueue.front();
             readyQueue.pop();
@@ -150,20 +265,12 @@ void Scheduler::scheduleRR() {
             auto coreID = getAvailableCoreWorkerID();
 
             if (coreID > 0) {
-                process->setCore(coreID);
-                cores[coreID - 1]->setProcess(process);
-
-                // Use a lambda function to handle requeueing the process after execution
-                cores[coreID - 1]->setProcessCompletionCallback([this](const std::shared_ptr<Process>& completedProcess) {
-                    if (!completedProcess->isFinished()) {
-                        std::lock_guard<std::mutex> queueLock(this->queueMutex);
-                        this->readyQueue.push(completedProcess);
-                    }
-                    else {
-                        std::lock_guard<std::mutex> processLock(this->processMutex);
-                        this->finishedProcesses.push_back(completedProcess);
-                    }
-                    });
+                // the swap-in may finish right away and requeue the process
+                lock.unlock();
+                if (!isReadyToRun(process, coreID)) {
+                    continue;
+                }
+                assignToCore(process, coreID);
             }
             else {
                 // No available core, put the process back at the front of the queue
@@ -173,6 +280,49 @@ void Scheduler::scheduleRR() {
     }
 }
 
+void Scheduler::pause() {
+    // The dispatch in progress finishes first, then the cores stop between two instructions
+    dispatchPaused = true;
+    {
+        std::lock_guard<std::mutex> dispatchLock(dispatchMutex);
+    }
+    for (auto& core : cores) {
+        core->pause();
+    }
+}
+
+void Scheduler::resume() {
+    for (auto& core : cores) {
+        core->resume();
+    }
+    dispatchPaused = false;
+}
+
+std::vector<std::shared_ptr<Process>> Scheduler::getReadyQueue() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    std::vector<std::shared_ptr<Process>> queued;
+    std::queue<std::shared_ptr<Process>> copy = readyQueue;
+    while (!copy.empty()) {
+        queued.push_back(copy.front());
+        copy.pop();
+    }
+    return queued;
+}
+
+void Scheduler::restoreProcess(const std::shared_ptr<Process>& process, int coreID) {
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        processes.push_back(process);
+        if (process->isFinished()) {
+            finishedProcesses.push_back(process);
+        }
+    }
+
+    if (coreID > 0 && coreID <= static_cast<int>(cores.size())) {
+        assignToCore(process, coreID);
+    }
+}
+
 const std::vector<std::unique_ptr<CoreWorker>>& Scheduler::getCoreWorkers() const {
     return cores;
 }
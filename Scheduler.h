@@ -6,6 +6,7 @@
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <windows.h>
 
 #include "Process.h"
@@ -26,6 +27,19 @@ public:
     void run(); // Start the scheduler
     void stop();
     const std::vector<std::unique_ptr<CoreWorker>>& getCores() const;
+    void setMemoryAccessCallback(std::function<MemoryAccess(std::shared_ptr<Process>, int)> callback); // Passed on to every core
+    void setTLBHitCallback(std::function<void(std::shared_ptr<Process>, const std::vector<int>&)> callback); // Passed on to every core
+    void invalidateTLBEntry(int pid, int pageNumber); // TLB shootdown on every core
+    void setSwapInCallback(std::function<bool(std::shared_ptr<Process>, int)> callback); // asked at dispatch with the core's NUMA node, false if the process is not resident and is being swapped in
+    void resumeProcess(const std::shared_ptr<Process>& process); // back into the ready queue once its swap-in is done
+    void setProcessFinishedCallback(std::function<void(std::shared_ptr<Process>)> callback); // called on the core's thread when a process finishes, to free its memory
+    int getDispatchingProcessID() const; // the process between its residency check and its core, -1 if none
+
+    // Checkpoint
+    void pause(); // stops dispatching and parks every core between two instructions
+    void resume();
+    std::vector<std::shared_ptr<Process>> getReadyQueue(); // in dispatch order
+    void restoreProcess(const std::shared_ptr<Process>& process, int coreID); // adds a restored process back on its core, 0 leaves it for resumeProcess
 
     void displayStatus();
     void saveReport();
@@ -46,8 +60,18 @@ private:
     std::vector<std::shared_ptr<Process>> finishedProcesses; // Add finished processes here
     std::mutex processMutex; // Protects access to the processes vector
     std::mutex queueMutex;   // Protects access to the readyQueue
+    std::function<bool(std::shared_ptr<Process>, int)> swapInCallback;
+    std::function<void(std::shared_ptr<Process>)> processFinishedCallback;
+
+    void onProcessCompletion(const std::shared_ptr<Process>& process); // a core let go of the process, finished or at the end of its quantum
+
+    bool isReadyToRun(const std::shared_ptr<Process>& process, int coreID); // false if the process left the ready queue to be swapped in
+    std::atomic<int> dispatchingProcessID{ -1 }; // must not be swapped out, it is found resident but not yet on a core
 
     bool running;
+    std::atomic<bool> dispatchPaused{ false };
+    std::mutex dispatchMutex; // held by the scheduler loop while it dispatches one process
+    void assignToCore(const std::shared_ptr<Process>& process, int coreID);
 
     void initializeCoreWorkers(); // Initialize the cores
     int getAvailableCoreWorkerID();
@@ -0,0 +1,220 @@
+#include "ShardedFlatAllocator.h"
+#include <iostream>
+#include <algorithm>
+
+ShardedFlatAllocator::ShardedFlatAllocator()
+    : memorySize(0), numLocalAllocations(0), numGlobalAllocations(0), numStolenAllocations(0) {}
+
+void ShardedFlatAllocator::initialize(ConfigurationManager* configManager) {
+    memorySize = static_cast<int>(configManager->getMaxOverallMemory());
+    int numShards = std::max(1, configManager->getMemoryShards());
+
+    shards.clear();
+    for (int i = 0; i < numShards; ++i) {
+        shards.emplace_back(new Shard());
+    }
+
+    if (numShards == 1) {
+        shards[0]->allocator.initialize(configManager, 0, memorySize);
+    }
+    else {
+        // Local arenas first, the global arena takes the rest of memory
+        int numLocals = numShards - 1;
+        int localSize = memorySize / (2 * numLocals);
+        for (int i = 1; i < numShards; ++i) {
+            shards[i]->allocator.initialize(configManager, (i - 1) * localSize, localSize);
+        }
+        shards[0]->allocator.initialize(configManager, numLocals * localSize, memorySize - numLocals * localSize);
+    }
+
+    numLocalAllocations = 0;
+    numGlobalAllocations = 0;
+    numStolenAllocations = 0;
+}
+
+std::vector<int> ShardedFlatAllocator::getShardOrder(int pid) const {
+    int numShards = static_cast<int>(shards.size());
+    if (numShards == 1) {
+        return { 0 };
+    }
+
+    int home = 1 + pid % (numShards - 1);
+    std::vector<int> order = { home, 0 };
+    for (int i = 1; i < numShards; ++i) {
+        int shard = 1 + (home - 1 + i) % (numShards - 1);
+        if (shard != home) {
+            order.push_back(shard);
+        }
+    }
+    return order;
+}
+
+bool ShardedFlatAllocator::allocate(Process process) {
+    std::vector<int> order = getShardOrder(process.getID());
+    for (size_t i = 0; i < order.size(); ++i) {
+        Shard& shard = *shards[order[i]];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.allocator.allocate(process)) {
+            if (shards.size() == 1 || i == 0) {
+                ++numLocalAllocations;
+            }
+            else if (order[i] == 0) {
+                ++numGlobalAllocations;
+            }
+            else {
+                ++numStolenAllocations;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShardedFlatAllocator::deallocate(int pid) {
+    // The process is most likely where allocate() tried first
+    for (int index : getShardOrder(pid)) {
+        Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.allocator.deallocate(pid)) {
+            return;
+        }
+    }
+}
+
+void ShardedFlatAllocator::deallocate(const std::vector<int>& pids) {
+    // Every arena is locked once for the whole batch
+    std::unordered_set<int> remaining(pids.begin(), pids.end());
+    for (auto& shard : shards) {
+        if (remaining.empty()) {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = remaining.begin(); it != remaining.end();) {
+            if (shard->allocator.deallocate(*it)) {
+                it = remaining.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+}
+
+int ShardedFlatAllocator::swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs) {
+    int numShards = static_cast<int>(shards.size());
+    int first = rand() % numShards;
+    for (int i = 0; i < numShards; ++i) {
+        Shard& shard = *shards[(first + i) % numShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        int pid = shard.allocator.swapOutRandomProcess(runningProcessIDs);
+        if (pid != -1) {
+            return pid;
+        }
+    }
+    return -1;
+}
+
+void ShardedFlatAllocator::displayMemory() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->allocator.displayMemory();
+    }
+}
+
+int ShardedFlatAllocator::getUsedMemory() const {
+    return memorySize - getFreeMemory();
+}
+
+int ShardedFlatAllocator::getFreeMemory() const {
+    int freeMemory = 0;
+    for (const auto& shard : shards) {
+        freeMemory += shard->allocator.getFreeMemory();
+    }
+    return freeMemory;
+}
+
+int ShardedFlatAllocator::getLargestFreeBlock() {
+    int largest = 0;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        largest = std::max(largest, shard->allocator.getLargestFreeBlock());
+    }
+    return largest;
+}
+
+float ShardedFlatAllocator::getExternalFragmentation() {
+    int freeMemory = getFreeMemory();
+    if (freeMemory == 0) {
+        return 0;
+    }
+    return std::max(0.0f, (1.0f - static_cast<float>(getLargestFreeBlock()) / freeMemory) * 100);
+}
+
+int ShardedFlatAllocator::compact(int maxMoves) {
+    int moves = 0;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        if (shard->allocator.getExternalFragmentation() > 0) {
+            moves += shard->allocator.compact(maxMoves);
+        }
+    }
+    return moves;
+}
+
+bool ShardedFlatAllocator::compactFor(int size) {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        if (shard->allocator.compactFor(size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+long long ShardedFlatAllocator::getNumCompactions() const {
+    long long total = 0;
+    for (const auto& shard : shards) {
+        total += shard->allocator.getNumCompactions();
+    }
+    return total;
+}
+
+long long ShardedFlatAllocator::getNumBlocksMoved() const {
+    long long total = 0;
+    for (const auto& shard : shards) {
+        total += shard->allocator.getNumBlocksMoved();
+    }
+    return total;
+}
+
+long long ShardedFlatAllocator::getMemoryMoved() const {
+    long long total = 0;
+    for (const auto& shard : shards) {
+        total += shard->allocator.getMemoryMoved();
+    }
+    return total;
+}
+
+long long ShardedFlatAllocator::getCompactionTime() const {
+    long long total = 0;
+    for (const auto& shard : shards) {
+        total += shard->allocator.getCompactionTime();
+    }
+    return total;
+}
+
+int ShardedFlatAllocator::getNumShards() const {
+    return static_cast<int>(shards.size());
+}
+
+long long ShardedFlatAllocator::getNumLocalAllocations() const {
+    return numLocalAllocations;
+}
+
+long long ShardedFlatAllocator::getNumGlobalAllocations() const {
+    return numGlobalAllocations;
+}
+
+long long ShardedFlatAllocator::getNumStolenAllocations() const {
+    return numStolenAllocations;
+}
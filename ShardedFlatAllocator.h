@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+
+#include "Process.h"
+#include "ConfigurationManager.h"
+#include "FlatAllocator.h"
+
+// Flat memory split into arenas that each have their own lock (for flat alloc), safe for concurrent use
+// With memory-shards > 1, half of memory is a global arena and the other half is split evenly into local arenas.
+// A process goes to its local arena (pid % locals) first, then the global arena, then any other local arena.
+class ShardedFlatAllocator
+{
+public:
+	ShardedFlatAllocator();
+
+	void initialize(ConfigurationManager* configManager);
+	bool allocate(Process process);
+	void deallocate(int pid);
+	void deallocate(const std::vector<int>& pids); // a batch of finished processes, one lock hold per arena
+	int swapOutRandomProcess(const std::unordered_set<int>& runningProcessIDs); // swap out a random process from any arena
+	void displayMemory();
+
+	int getUsedMemory() const; // lock free
+	int getFreeMemory() const; // lock free
+	int getLargestFreeBlock();
+	float getExternalFragmentation(); // percentage of free memory that is not in the largest free block
+
+	int compact(int maxMoves); // compacts every arena by up to maxMoves blocks
+	bool compactFor(int size); // compacts arenas until one of them has a free block of this size
+
+	// Compaction stats, summed over the arenas
+	long long getNumCompactions() const;
+	long long getNumBlocksMoved() const;
+	long long getMemoryMoved() const;
+	long long getCompactionTime() const;
+
+	// Shard stats
+	int getNumShards() const;
+	long long getNumLocalAllocations() const;	// served by the process's own arena
+	long long getNumGlobalAllocations() const;	// fell back to the global arena
+	long long getNumStolenAllocations() const;	// served by another process's local arena
+
+private:
+	struct Shard {
+		std::mutex mutex;
+		FlatAllocator allocator;
+	};
+
+	std::vector<std::unique_ptr<Shard>> shards; // shards[0] is the global arena
+	int memorySize;
+
+	std::atomic<long long> numLocalAllocations;
+	std::atomic<long long> numGlobalAllocations;
+	std::atomic<long long> numStolenAllocations;
+
+	std::vector<int> getShardOrder(int pid) const; // arenas to try for a process, in order
+};
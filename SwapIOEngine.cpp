@@ -0,0 +1,431 @@
+#include "SwapIOEngine.h"
+#include <algorithm>
+
+namespace {
+    const size_t MAX_WRITE_BATCH = 256; // requests taken off the write queue at once
+    const size_t MAX_QUEUED_WRITES = 4 * MAX_WRITE_BATCH; // submitters wait beyond this, evictions cannot outrun the disk forever
+
+    thread_local bool isSwapIOWorker = false; // a swap-in evicting pages must not wait for room in the queue it drains itself
+}
+
+SwapIOEngine::SwapIOEngine(BackingStore& backingStore)
+    : backingStore(backingStore), stopping(false), writeBatchInFlight(false), nextSequence(0), queueDepth(0), maxQueueDepth(0), numSwapInsRunning(0),
+      numWriteBatches(0), numBatchedWrites(0), numThrottledWrites(0), numReadsFromQueue(0),
+      depthHistogram(NUM_DEPTH_BUCKETS, 0), writeLatencyHistogram(NUM_LATENCY_BUCKETS, 0), readLatencyHistogram(NUM_LATENCY_BUCKETS, 0),
+      swapInLatencyHistogram(NUM_LATENCY_BUCKETS, 0) {}
+
+SwapIOEngine::~SwapIOEngine() {
+    stop();
+}
+
+void SwapIOEngine::start(int numThreads) {
+    stop();
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = false;
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&SwapIOEngine::run, this);
+    }
+}
+
+void SwapIOEngine::stop() {
+    // Requests submitted from now on run on the caller, the workers finish the queue before they exit
+    std::vector<std::thread> stoppingWorkers;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        stoppingWorkers.swap(workers);
+    }
+    queueReady.notify_all();
+
+    for (auto& worker : stoppingWorkers) {
+        worker.join();
+    }
+}
+
+void SwapIOEngine::submitWrite(int slot, int pid, int pageNumber, std::function<void()> completion) {
+    Request request;
+    request.type = RequestType::Write;
+    request.slot = slot;
+    request.pid = pid;
+    request.pageNumber = pageNumber;
+    request.writeCompletion = completion;
+    submit(request);
+}
+
+void SwapIOEngine::submitRead(int slot, int pageNumber, std::function<void(bool)> completion) {
+    Request request;
+    request.type = RequestType::Read;
+    request.slot = slot;
+    request.pid = -1;
+    request.pageNumber = pageNumber;
+    request.readCompletion = completion;
+    submit(request);
+}
+
+void SwapIOEngine::submitStore(std::shared_ptr<Process> process) {
+    Request request;
+    request.type = RequestType::Store;
+    request.slot = -1;
+    request.pid = process->getID();
+    request.pageNumber = -1;
+    request.process = process;
+    submit(request);
+}
+
+void SwapIOEngine::submitRemove(int pid) {
+    Request request;
+    request.type = RequestType::Remove;
+    request.slot = -1;
+    request.pid = pid;
+    request.pageNumber = -1;
+    submit(request);
+}
+
+void SwapIOEngine::submitSwapIn(std::function<void()> swapIn) {
+    Request request;
+    request.type = RequestType::SwapIn;
+    request.slot = -1;
+    request.pid = -1;
+    request.pageNumber = -1;
+    request.swapIn = swapIn;
+    submit(request);
+}
+
+void SwapIOEngine::submit(Request request) {
+    request.submitTime = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    request.sequence = nextSequence++;
+
+    int depth = ++queueDepth;
+    maxQueueDepth = std::max(maxQueueDepth, depth);
+    int depthBucket = 0;
+    while (depthBucket < NUM_DEPTH_BUCKETS - 1 && depth >= (2 << depthBucket)) {
+        ++depthBucket;
+    }
+    ++depthHistogram[depthBucket];
+
+    if (workers.empty()) {
+        // Synchronous: run it here, the caller waits like it did on the backing store
+        lock.unlock();
+        if (request.type == RequestType::Read) {
+            bool found = runRead(request);
+            if (request.readCompletion) {
+                request.readCompletion(found);
+            }
+        }
+        else if (request.type == RequestType::SwapIn) {
+            runSwapIn(request);
+        }
+        else {
+            std::vector<Request> batch(1, request);
+            runWriteBatch(batch);
+        }
+        return;
+    }
+
+    if (request.type == RequestType::Read || request.type == RequestType::SwapIn) {
+        readQueue.push_back(request);
+    }
+    else {
+        // Evictions submit under the allocator lock that swap-ins wait for, once every worker is in a swap-in nobody drains the queue
+        if (writeQueue.size() >= MAX_QUEUED_WRITES && !isSwapIOWorker) {
+            ++numThrottledWrites;
+            queueDrained.wait(lock, [this] {
+                return writeQueue.size() < MAX_QUEUED_WRITES || workers.empty() || numSwapInsRunning >= static_cast<int>(workers.size());
+                });
+        }
+        if (request.type == RequestType::Write) {
+            pendingWrites[request.slot] = { request.pid, request.pageNumber, request.sequence };
+        }
+        else if (request.type == RequestType::Store) {
+            pendingStores[request.pid] = { request.process, request.sequence };
+        }
+        else {
+            pendingStores.erase(request.pid); // a load after the remove finds nothing
+        }
+        writeQueue.push_back(request);
+    }
+    lock.unlock();
+    queueReady.notify_one();
+}
+
+bool SwapIOEngine::readPage(int slot, int pageNumber) {
+    Request request;
+    request.type = RequestType::Read;
+    request.slot = slot;
+    request.pid = -1;
+    request.pageNumber = pageNumber;
+    request.submitTime = std::chrono::steady_clock::now();
+
+    // The faulting thread does the read itself, it has to wait for it anyway
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ++queueDepth;
+    }
+    return runRead(request);
+}
+
+std::shared_ptr<Process> SwapIOEngine::loadProcess(int pid) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto pending = pendingStores.find(pid);
+        if (pending != pendingStores.end()) {
+            ++numReadsFromQueue;
+            return pending->second.first;
+        }
+    }
+    return backingStore.loadProcess(pid);
+}
+
+void SwapIOEngine::drain() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueDrained.wait(lock, [this] { return queueDepth == 0; });
+}
+
+void SwapIOEngine::run() {
+    isSwapIOWorker = true;
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueReady.wait(lock, [this] { return stopping || !readQueue.empty() || (!writeQueue.empty() && !writeBatchInFlight); });
+
+        // A fault is waiting on every read, reads go before the writes
+        if (!readQueue.empty()) {
+            Request request = readQueue.front();
+            readQueue.pop_front();
+            bool isSwapIn = request.type == RequestType::SwapIn;
+            if (isSwapIn && ++numSwapInsRunning >= static_cast<int>(workers.size())) {
+                queueDrained.notify_all(); // a throttled eviction may hold the lock this swap-in needs
+            }
+            lock.unlock();
+            if (isSwapIn) {
+                runSwapIn(request);
+            }
+            else {
+                bool found = runRead(request);
+                if (request.readCompletion) {
+                    request.readCompletion(found);
+                }
+            }
+            lock.lock();
+            if (isSwapIn) {
+                --numSwapInsRunning;
+            }
+            continue;
+        }
+
+        if (!writeQueue.empty() && !writeBatchInFlight) {
+            size_t batchSize = std::min(writeQueue.size(), MAX_WRITE_BATCH);
+            std::vector<Request> batch(writeQueue.begin(), writeQueue.begin() + batchSize);
+            writeQueue.erase(writeQueue.begin(), writeQueue.begin() + batchSize);
+            writeBatchInFlight = true;
+            lock.unlock();
+            queueDrained.notify_all(); // room in the write queue
+            runWriteBatch(batch);
+            lock.lock();
+            continue;
+        }
+
+        if (stopping) {
+            // another worker may still be writing a batch, it finishes the queue
+            break;
+        }
+    }
+}
+
+void SwapIOEngine::runWriteBatch(std::vector<Request>& batch) {
+    // Process records first, then the pages by slot; a slot written twice in the batch only needs the newer page
+    std::vector<Request*> writes;
+    for (auto& request : batch) {
+        if (request.type == RequestType::Store) {
+            backingStore.storeProcess(request.process);
+        }
+        else if (request.type == RequestType::Remove) {
+            backingStore.removeProcess(request.pid);
+        }
+        else {
+            writes.push_back(&request);
+        }
+    }
+    std::sort(writes.begin(), writes.end(), [](const Request* a, const Request* b) {
+        return a->slot != b->slot ? a->slot < b->slot : a->sequence < b->sequence;
+        });
+
+    std::vector<std::pair<int, int>> run;
+    int runStart = -1;
+    for (size_t i = 0; i < writes.size(); ++i) {
+        if (i + 1 < writes.size() && writes[i + 1]->slot == writes[i]->slot) {
+            continue; // overwritten later in the batch
+        }
+
+        if (!run.empty() && writes[i]->slot != runStart + static_cast<int>(run.size())) {
+            backingStore.writePages(runStart, run);
+            run.clear();
+        }
+        if (run.empty()) {
+            runStart = writes[i]->slot;
+        }
+        run.push_back({ writes[i]->pid, writes[i]->pageNumber });
+    }
+    if (!run.empty()) {
+        backingStore.writePages(runStart, run);
+    }
+
+    for (auto& request : batch) {
+        if (request.writeCompletion) {
+            request.writeCompletion();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (auto* write : writes) {
+            auto pending = pendingWrites.find(write->slot);
+            if (pending != pendingWrites.end() && pending->second.sequence == write->sequence) {
+                pendingWrites.erase(pending);
+            }
+        }
+        for (const auto& request : batch) {
+            auto pending = request.type == RequestType::Store ? pendingStores.find(request.pid) : pendingStores.end();
+            if (pending != pendingStores.end() && pending->second.second == request.sequence) {
+                pendingStores.erase(pending);
+            }
+        }
+
+        ++numWriteBatches;
+        if (writes.size() > 1) {
+            numBatchedWrites += static_cast<long long>(writes.size());
+        }
+        for (const auto& request : batch) {
+            recordLatency(writeLatencyHistogram, request.submitTime);
+        }
+        queueDepth -= static_cast<int>(batch.size());
+        writeBatchInFlight = false;
+    }
+    queueReady.notify_all(); // the next batch can go
+    queueDrained.notify_all();
+}
+
+bool SwapIOEngine::runRead(const Request& request) {
+    bool found;
+    bool fromQueue = false;
+    {
+        // the write may not have reached the file yet
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto pending = pendingWrites.find(request.slot);
+        if (pending != pendingWrites.end()) {
+            fromQueue = true;
+            found = pending->second.pageNumber == request.pageNumber;
+        }
+    }
+
+    if (fromQueue) {
+        ++numReadsFromQueue;
+    }
+    else {
+        // the slot is still referenced by the reader, so no new write to it can be queued meanwhile
+        found = backingStore.readPage(request.slot, request.pageNumber);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        recordLatency(readLatencyHistogram, request.submitTime);
+        --queueDepth;
+    }
+    queueDrained.notify_all();
+    return found;
+}
+
+void SwapIOEngine::runSwapIn(const Request& request) {
+    request.swapIn();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        recordLatency(swapInLatencyHistogram, request.submitTime);
+        --queueDepth;
+    }
+    queueDrained.notify_all();
+}
+
+void SwapIOEngine::recordLatency(std::vector<long long>& histogram, std::chrono::steady_clock::time_point submitTime) {
+    ++histogram[getLatencyBucket(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submitTime).count())];
+}
+
+int SwapIOEngine::getLatencyBucket(long long micros) {
+    int bucket = 0;
+    for (long long limit = 16; bucket < NUM_LATENCY_BUCKETS - 1 && micros >= limit; limit *= 4) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+int SwapIOEngine::getNumThreads() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return static_cast<int>(workers.size());
+}
+
+int SwapIOEngine::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return queueDepth;
+}
+
+int SwapIOEngine::getMaxQueueDepth() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return maxQueueDepth;
+}
+
+long long SwapIOEngine::getNumWriteBatches() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return numWriteBatches;
+}
+
+long long SwapIOEngine::getNumBatchedWrites() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return numBatchedWrites;
+}
+
+long long SwapIOEngine::getNumThrottledWrites() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return numThrottledWrites;
+}
+
+long long SwapIOEngine::getNumReadsFromQueue() const {
+    return numReadsFromQueue;
+}
+
+std::vector<long long> SwapIOEngine::getDepthHistogram() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return depthHistogram;
+}
+
+std::vector<long long> SwapIOEngine::getWriteLatencyHistogram() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return writeLatencyHistogram;
+}
+
+std::vector<long long> SwapIOEngine::getReadLatencyHistogram() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return readLatencyHistogram;
+}
+
+std::vector<long long> SwapIOEngine::getSwapInLatencyHistogram() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return swapInLatencyHistogram;
+}
+
+std::string SwapIOEngine::getLatencyBucketName(int bucket) {
+    static const char* names[NUM_LATENCY_BUCKETS] = { "<16us", "<64us", "<256us", "<1ms", "<4ms", "<16ms", "<64ms", ">=64ms" };
+    return names[bucket];
+}
+
+std::string SwapIOEngine::getDepthBucketName(int bucket) {
+    if (bucket == NUM_DEPTH_BUCKETS - 1) {
+        return std::to_string(1 << bucket) + "+";
+    }
+    if (bucket == 0) {
+        return "1";
+    }
+    return std::to_string(1 << bucket) + "-" + std::to_string((2 << bucket) - 1);
+}
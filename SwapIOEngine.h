@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "BackingStore.h"
+#include "Process.h"
+
+// Asynchronous swap I/O in front of the backing store
+// Evictions only queue their writes, worker threads take every queued write as one batch, sort it by slot and
+// write each run of adjacent slots back as one range. Reads jump ahead of the writes, a read of a slot whose write
+// is still queued or in flight is answered from the queue.
+// With no worker threads every request runs on the caller, like the backing store calls did before.
+class SwapIOEngine
+{
+public:
+    static const int NUM_LATENCY_BUCKETS = 8; // <16us, <64us, <256us, <1ms, <4ms, <16ms, <64ms, longer
+    static const int NUM_DEPTH_BUCKETS = 8; // 1, 2-3, 4-7, ... 64-127, 128 and more
+
+    SwapIOEngine(BackingStore& backingStore);
+    ~SwapIOEngine();
+
+    void start(int numThreads);
+    void stop(); // finishes the queued requests first
+
+    // Submission, the completion runs on a worker thread once the request is done
+    void submitWrite(int slot, int pid, int pageNumber, std::function<void()> completion = nullptr);
+    void submitRead(int slot, int pageNumber, std::function<void(bool)> completion); // completion gets false if the slot held another page
+    void submitStore(std::shared_ptr<Process> process); // whole process record (flat and buddy swap-out)
+    void submitRemove(int pid); // drops the process record once the stores before it are done
+    void submitSwapIn(std::function<void()> swapIn); // runs the swap-in on a worker, ahead of the queued writes
+
+    bool readPage(int slot, int pageNumber); // waits for the read, false if the slot held another page
+    std::shared_ptr<Process> loadProcess(int pid); // the process record, answered from a queued store if there is one; throws if there is none
+    void drain(); // waits until every submitted request is done
+
+    // Stats
+    int getNumThreads() const;
+    int getQueueDepth() const; // queued and in-flight requests
+    int getMaxQueueDepth() const;
+    long long getNumWriteBatches() const;
+    long long getNumBatchedWrites() const; // page writes that went out in a batch of more than one
+    long long getNumThrottledWrites() const; // submissions that waited for room in a full write queue
+    long long getNumReadsFromQueue() const; // reads answered by a queued or in-flight write
+    std::vector<long long> getDepthHistogram() const; // queue depth seen by each submission
+    std::vector<long long> getWriteLatencyHistogram() const; // submission to completion
+    std::vector<long long> getReadLatencyHistogram() const;
+    std::vector<long long> getSwapInLatencyHistogram() const;
+    static int getLatencyBucket(long long micros);
+    static std::string getLatencyBucketName(int bucket);
+    static std::string getDepthBucketName(int bucket);
+
+private:
+    enum class RequestType { Write, Read, Store, Remove, SwapIn };
+
+    struct Request {
+        RequestType type;
+        int slot;
+        int pid;
+        int pageNumber;
+        long long sequence; // orders writes to the same slot
+        std::function<void()> writeCompletion;
+        std::function<void(bool)> readCompletion;
+        std::function<void()> swapIn;
+        std::shared_ptr<Process> process;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    struct PendingWrite {
+        int pid;
+        int pageNumber;
+        long long sequence;
+    };
+
+    BackingStore& backingStore;
+    std::vector<std::thread> workers;
+    bool stopping;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady; // a request was submitted or a write batch finished
+    std::condition_variable queueDrained; // requests finished, the write queue has room
+    std::deque<Request> readQueue; // reads and swap-ins
+    std::deque<Request> writeQueue; // writes, stores and removes, in submission order
+    std::unordered_map<int, PendingWrite> pendingWrites; // slot -> newest write not yet in the file
+    std::unordered_map<int, std::pair<std::shared_ptr<Process>, long long>> pendingStores; // pid -> newest record not yet in the file, and its sequence
+    bool writeBatchInFlight; // one batch at a time keeps the writes to a slot in order
+    long long nextSequence;
+    int queueDepth;
+    int maxQueueDepth;
+    int numSwapInsRunning; // workers inside a swap-in, they may be waiting for an allocator lock held by a throttled submitter
+
+    long long numWriteBatches;
+    long long numBatchedWrites;
+    long long numThrottledWrites;
+    std::atomic<long long> numReadsFromQueue;
+    std::vector<long long> depthHistogram;
+    std::vector<long long> writeLatencyHistogram;
+    std::vector<long long> readLatencyHistogram;
+    std::vector<long long> swapInLatencyHistogram;
+
+    void run();
+    void submit(Request request); // queues the request, or runs it on the caller if there are no workers
+    void runWriteBatch(std::vector<Request>& batch);
+    bool runRead(const Request& request);
+    void runSwapIn(const Request& request);
+    void recordLatency(std::vector<long long>& histogram, std::chrono::steady_clock::time_point submitTime); // under queueMutex
+};
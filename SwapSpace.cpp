@@ -0,0 +1,122 @@
+#include "SwapSpace.h"
+
+SwapSpace::SwapSpace() : numUsedSlots(0) {}
+
+void SwapSpace::initialize(int numSlots) {
+    freeSlots.resize(numSlots, true);
+    slotReferences.assign(numSlots, 0);
+    slotOwners.assign(numSlots, { -1, -1 });
+    processSlots.clear();
+    numUsedSlots = 0;
+}
+
+int SwapSpace::allocate(int references) {
+    int slot = freeSlots.findFirstSet();
+    if (slot == -1) {
+        return -1;
+    }
+
+    freeSlots.clear(slot);
+    slotReferences[slot] = references;
+    ++numUsedSlots;
+    return slot;
+}
+
+void SwapSpace::reference(int slot) {
+    ++slotReferences[slot];
+}
+
+bool SwapSpace::release(int slot) {
+    if (--slotReferences[slot] > 0) {
+        return false;
+    }
+
+    slotReferences[slot] = 0;
+    slotOwners[slot] = { -1, -1 };
+    freeSlots.set(slot);
+    --numUsedSlots;
+    return true;
+}
+
+int SwapSpace::getReferences(int slot) const {
+    return slotReferences[slot];
+}
+
+void SwapSpace::assign(int pid, int pageNumber, int slot) {
+    processSlots[pid][pageNumber] = slot;
+    slotOwners[slot] = { pid, pageNumber };
+}
+
+int SwapSpace::take(int pid, int pageNumber) {
+    auto slots = processSlots.find(pid);
+    if (slots == processSlots.end()) {
+        return -1;
+    }
+
+    auto slot = slots->second.find(pageNumber);
+    if (slot == slots->second.end()) {
+        return -1;
+    }
+
+    int swapSlot = slot->second;
+    slots->second.erase(slot);
+    if (slots->second.empty()) {
+        processSlots.erase(slots);
+    }
+    return swapSlot;
+}
+
+int SwapSpace::find(int pid, int pageNumber) const {
+    auto slots = processSlots.find(pid);
+    if (slots == processSlots.end()) {
+        return -1;
+    }
+
+    auto slot = slots->second.find(pageNumber);
+    return slot != slots->second.end() ? slot->second : -1;
+}
+
+int SwapSpace::getSlotPage(int slot, int pid) const {
+    // the owner may have read the page back or gone away since, only its current swap map counts
+    const std::pair<int, int>& owner = slotOwners[slot];
+    if (owner.first != pid || find(pid, owner.second) != slot) {
+        return -1;
+    }
+    return owner.second;
+}
+
+std::vector<int> SwapSpace::removeProcess(int pid) {
+    std::vector<int> slots;
+    auto entry = processSlots.find(pid);
+    if (entry != processSlots.end()) {
+        for (const auto& slot : entry->second) {
+            slots.push_back(slot.second);
+        }
+        processSlots.erase(entry);
+    }
+    return slots;
+}
+
+int SwapSpace::getNumSlots() const {
+    return freeSlots.size();
+}
+
+int SwapSpace::getNumUsedSlots() const {
+    return numUsedSlots;
+}
+
+int SwapSpace::getNumProcessSlots(int pid) const {
+    auto slots = processSlots.find(pid);
+    return slots != processSlots.end() ? static_cast<int>(slots->second.size()) : 0;
+}
+
+std::vector<int> SwapSpace::getProcessPages(int pid) const {
+    std::vector<int> pages;
+    auto slots = processSlots.find(pid);
+    if (slots != processSlots.end()) {
+        for (const auto& slot : slots->second) {
+            pages.push_back(slot.first);
+        }
+    }
+    return pages;
+}
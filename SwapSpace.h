@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include "FrameBitmap.h"
+
+// Swap map of the paging allocator: which page-sized slots of the swap area are in use and which pages they hold
+// A bitmap finds free slots, a reference count per slot lets processes sharing a page share its slot
+// Not thread-safe, the paging allocator calls it under its lock
+class SwapSpace
+{
+public:
+	SwapSpace();
+
+	void initialize(int numSlots);
+
+	int allocate(int references); // a free slot with the given references, -1 if swap is full
+	void reference(int slot);
+	bool release(int slot); // drops a reference, true if the slot is free again
+	int getReferences(int slot) const;
+
+	// Per-process slot lists
+	void assign(int pid, int pageNumber, int slot); // the page of the process is in the slot
+	int take(int pid, int pageNumber); // removes the page from the process's list, returns its slot or -1
+	int find(int pid, int pageNumber) const; // slot of the page, -1 if it is not swapped
+	int getSlotPage(int slot, int pid) const; // page of the process in the slot, -1 if the slot holds none of its pages
+	std::vector<int> removeProcess(int pid); // forgets the process, returns its slots without releasing them
+
+	int getNumSlots() const;
+	int getNumUsedSlots() const; // safe to call without the allocator lock
+	int getNumProcessSlots(int pid) const; // pages of the process in swap
+	std::vector<int> getProcessPages(int pid) const; // page numbers of the process in swap, in no particular order
+
+private:
+	FrameBitmap freeSlots; // set bit = free slot
+	std::vector<int> slotReferences;
+	std::unordered_map<int, std::unordered_map<int, int>> processSlots; // pid -> page number -> slot
+	std::vector<std::pair<int, int>> slotOwners; // (pid, page number) last assigned to each slot, for readahead
+	std::atomic<int> numUsedSlots;
+};
@@ -0,0 +1,124 @@
+#include "TLB.h"
+
+TLB::TLB()
+    : numSets(0), ways(0), asidTagged(true), currentPID(-1), clock(0), numHits(0), numMisses(0), numFlushes(0) {}
+
+void TLB::configure(int numEntries, int newWays, bool newAsidTagged) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+
+    ways = newWays > 0 ? newWays : 1;
+    numSets = numEntries > 0 ? (numEntries + ways - 1) / ways : 0;
+    asidTagged = newAsidTagged;
+    entries.assign(static_cast<size_t>(numSets) * ways, { false, -1, -1, false, -1, 0 });
+    setGenerations.assign(numSets, 0);
+}
+
+bool TLB::isEnabled() const {
+    return numSets > 0;
+}
+
+int TLB::getSet(int pid, int pageNumber) const {
+    // mix the pid in so processes do not all start in set 0
+    unsigned int hash = static_cast<unsigned int>(pageNumber) ^ (static_cast<unsigned int>(pid) * 2654435761u);
+    return static_cast<int>(hash % numSets);
+}
+
+bool TLB::lookup(int pid, int pageNumber, bool isWrite, int& node) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+
+    Entry* set = &entries[static_cast<size_t>(getSet(pid, pageNumber)) * ways];
+    for (int way = 0; way < ways; ++way) {
+        if (set[way].valid && set[way].pid == pid && set[way].pageNumber == pageNumber && (set[way].writable || !isWrite)) {
+            set[way].lastUsed = ++clock;
+            node = set[way].node;
+            ++numHits;
+            return true;
+        }
+    }
+    ++numMisses;
+    return false;
+}
+
+long long TLB::getGeneration(int pid, int pageNumber) const {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    return numSets > 0 ? setGenerations[getSet(pid, pageNumber)] : 0;
+}
+
+void TLB::insert(int pid, int pageNumber, bool writable, int node, long long generation) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+
+    // The page may have been evicted or moved after the walk, the next reference walks the page table again
+    if (setGenerations[getSet(pid, pageNumber)] != generation) {
+        return;
+    }
+
+    // reuse the entry of the page if it is cached read-only, else replace an invalid entry, otherwise the least recently used one
+    Entry* set = &entries[static_cast<size_t>(getSet(pid, pageNumber)) * ways];
+    Entry* victim = nullptr;
+    for (int way = 0; way < ways; ++way) {
+        if (set[way].valid && set[way].pid == pid && set[way].pageNumber == pageNumber) {
+            victim = &set[way];
+            break;
+        }
+    }
+    if (!victim) {
+        victim = &set[0];
+        for (int way = 0; way < ways; ++way) {
+            if (!set[way].valid) {
+                victim = &set[way];
+                break;
+            }
+            if (set[way].lastUsed < victim->lastUsed) {
+                victim = &set[way];
+            }
+        }
+    }
+    *victim = { true, pid, pageNumber, writable, node, ++clock };
+}
+
+void TLB::invalidate(int pid, int pageNumber) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    if (numSets == 0) {
+        return;
+    }
+
+    int setIndex = getSet(pid, pageNumber);
+    ++setGenerations[setIndex]; // even if the page is not cached yet, a walk in flight may be about to fill it
+    Entry* set = &entries[static_cast<size_t>(setIndex) * ways];
+    for (int way = 0; way < ways; ++way) {
+        if (set[way].valid && set[way].pid == pid && set[way].pageNumber == pageNumber) {
+            set[way].valid = false;
+        }
+    }
+}
+
+void TLB::contextSwitch(int pid) {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+
+    if (pid != currentPID && !asidTagged && currentPID != -1) {
+        flush();
+    }
+    currentPID = pid;
+}
+
+void TLB::flush() {
+    for (auto& entry : entries) {
+        entry.valid = false;
+    }
+    ++numFlushes;
+}
+
+long long TLB::getNumHits() const {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    return numHits;
+}
+
+long long TLB::getNumMisses() const {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    return numMisses;
+}
+
+long long TLB::getNumFlushes() const {
+    std::lock_guard<std::mutex> lock(tlbMutex);
+    return numFlushes;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+
+// Translation lookaside buffer of a core (for paging alloc)
+// Set-associative with LRU replacement inside a set; entries are tagged with the process id (ASID)
+class TLB
+{
+public:
+	TLB();
+
+	void configure(int numEntries, int ways, bool asidTagged); // numEntries 0 disables the TLB
+	bool isEnabled() const;
+
+	bool lookup(int pid, int pageNumber, bool isWrite, int& node); // true on a hit (node is set), counts the lookup; a write to a read-only entry misses
+	long long getGeneration(int pid, int pageNumber) const; // read before the page table walk that fills the entry
+	void insert(int pid, int pageNumber, bool writable, int node, long long generation); // fill after a page table walk, upgrades an existing read-only entry; dropped if a shootdown hit the set since the generation was read
+	void invalidate(int pid, int pageNumber); // shootdown after the page was evicted
+	void contextSwitch(int pid); // flushes everything unless entries are tagged with the ASID
+
+	// Stats
+	long long getNumHits() const;
+	long long getNumMisses() const;
+	long long getNumFlushes() const;
+
+private:
+	struct Entry {
+		bool valid;
+		int pid;	// ASID
+		int pageNumber;
+		bool writable;	// false until a write walked the page table, shared pages have to take their copy-on-write fault
+		int node;	// NUMA node of the frame
+		long long lastUsed;	// for LRU inside the set
+	};
+
+	std::vector<Entry> entries;	// numSets * ways, a set is contiguous
+	std::vector<long long> setGenerations;	// shootdowns of each set, a walk that raced with one must not fill a stale translation
+	int numSets;
+	int ways;
+	bool asidTagged;
+	int currentPID;
+	long long clock;
+
+	long long numHits;
+	long long numMisses;
+	long long numFlushes;
+
+	mutable std::mutex tlbMutex; // lookups come from the core, shootdowns from the memory manager
+
+	int getSet(int pid, int pageNumber) const;
+	void flush();
+};
@@ -0,0 +1,34 @@
+#include "WorkingSet.h"
+
+WorkingSet::WorkingSet(int window, int numPages)
+    : window(window), next(0), pageCounts(numPages, 0), size(0) {}
+
+void WorkingSet::reference(int pageNumber) {
+    if (window <= 0) {
+        return;
+    }
+
+    if (recentPages.size() < static_cast<size_t>(window)) {
+        recentPages.push_back(pageNumber);
+    }
+    else {
+        // the oldest reference leaves the window
+        if (--pageCounts[recentPages[next]] == 0) {
+            --size;
+        }
+        recentPages[next] = pageNumber;
+    }
+    next = (next + 1) % window;
+
+    if (pageCounts[pageNumber]++ == 0) {
+        ++size;
+    }
+}
+
+int WorkingSet::getSize() const {
+    return size;
+}
+
+bool WorkingSet::contains(int pageNumber) const {
+    return pageNumber >= 0 && pageNumber < static_cast<int>(pageCounts.size()) && pageCounts[pageNumber] > 0;
+}
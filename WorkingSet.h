@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Working set of a process (for paging alloc): the distinct pages among its last `window` page references
+// Kept incrementally, each reference is O(1)
+class WorkingSet
+{
+public:
+	WorkingSet(int window = 0, int numPages = 0);
+
+	void reference(int pageNumber);
+	int getSize() const; // pages in the working set
+	bool contains(int pageNumber) const;
+
+private:
+	int window;
+	std::vector<int> recentPages; // ring buffer of the last references
+	size_t next;
+	std::vector<int> pageCounts; // references of each page inside the window
+	int size;
+};
@@ -5,23 +5,84 @@
 
 extern ConsoleManager consoleManager;	
 
-Process::Process() : id(0), totalInstructions(0), memorySize(0), pageSize(0) {
+Process::Process() : id(0), parentID(-1), totalInstructions(0), memorySize(0), pageSize(0),
+	nextMemoryReference(0), nextReferenceWrite(false), referenceSeed(1), numMemoryReferences(0), numMinorFaults(0), numMajorFaults(0),
+	numLocalAccesses(0), numRemoteAccesses(0), numSwapIns(0), waitTime(0) {
 	// Initialize other members if needed
 }
 
 Process::Process(std::string name, int id, int totalInstructions, float memorySize, float pageSize)
 	:	processName(name), 
 		id(id),
+		parentID(-1),
 		core(-1),
 		creationTime(std::chrono::system_clock::now()),
 		finished(false),
 		currentInstruction(0),
 		totalInstructions(totalInstructions),
 		memorySize(memorySize),
-		pageSize(pageSize)
+		pageSize(pageSize),
+		nextMemoryReference(0),
+		nextReferenceWrite(false),
+		referenceSeed(static_cast<unsigned int>(id) * 2654435761u + 1),
+		numMemoryReferences(0),
+		numMinorFaults(0),
+		numMajorFaults(0),
+		numLocalAccesses(0),
+		numRemoteAccesses(0),
+		numSwapIns(0),
+		waitTime(0)
 
 {}
 
+Process::Process(std::string name, const State& state)
+	:	processName(name),
+		id(state.id),
+		parentID(state.parentID),
+		core(state.core),
+		creationTime(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(state.creationTime)))),
+		finished(state.finished != 0),
+		currentInstruction(state.currentInstruction),
+		totalInstructions(state.totalInstructions),
+		memorySize(state.memorySize),
+		pageSize(state.pageSize),
+		nextMemoryReference(state.nextMemoryReference),
+		nextReferenceWrite(state.nextReferenceWrite != 0),
+		referenceSeed(state.referenceSeed),
+		numMemoryReferences(state.numMemoryReferences),
+		numMinorFaults(state.numMinorFaults),
+		numMajorFaults(state.numMajorFaults),
+		numLocalAccesses(state.numLocalAccesses),
+		numRemoteAccesses(state.numRemoteAccesses),
+		numSwapIns(state.numSwapIns),
+		waitTime(state.waitTime)
+
+{}
+
+Process::State Process::getState() const {
+	State state = {};
+	state.id = id;
+	state.parentID = parentID;
+	state.core = core;
+	state.finished = finished ? 1 : 0;
+	state.currentInstruction = currentInstruction;
+	state.totalInstructions = totalInstructions;
+	state.memorySize = memorySize;
+	state.pageSize = pageSize;
+	state.nextMemoryReference = nextMemoryReference;
+	state.nextReferenceWrite = nextReferenceWrite ? 1 : 0;
+	state.referenceSeed = referenceSeed;
+	state.creationTime = std::chrono::duration_cast<std::chrono::microseconds>(creationTime.time_since_epoch()).count();
+	state.numMemoryReferences = numMemoryReferences;
+	state.numMinorFaults = numMinorFaults;
+	state.numMajorFaults = numMajorFaults;
+	state.numLocalAccesses = numLocalAccesses;
+	state.numRemoteAccesses = numRemoteAccesses;
+	state.numSwapIns = numSwapIns;
+	state.waitTime = waitTime;
+	return state;
+}
+
 std::string Process::getName() const {
 	return processName;
 }
@@ -30,6 +91,14 @@ int Process::getID() const {
 	return id;
 }
 
+int Process::getParentID() const {
+	return parentID;
+}
+
+void Process::setParentID(int parentID) {
+	this->parentID = parentID;
+}
+
 int Process::getCurrentInstruction() const {
 	return currentInstruction;
 }
@@ -74,7 +143,89 @@ float Process::getPageSize() const {
 void Process::execute() {
 	if (currentInstruction < totalInstructions) { // If the process has not finished executing
 		currentInstruction++; // Increment the current instruction
+		numMemoryReferences++; // The instruction touched nextMemoryReference
+		generateNextMemoryReference();
 	} else {
 		finished = true; // Set the process to finished
 	}
 }
+
+int Process::getNextMemoryReference() const {
+	return nextMemoryReference;
+}
+
+bool Process::isNextReferenceWrite() const {
+	return nextReferenceWrite;
+}
+
+// Mostly sequential accesses with an occasional jump, so pages are reused before the process moves on
+void Process::generateNextMemoryReference() {
+	int size = static_cast<int>(memorySize);
+	if (size <= 0) {
+		return;
+	}
+
+	referenceSeed ^= referenceSeed << 13;
+	referenceSeed ^= referenceSeed >> 17;
+	referenceSeed ^= referenceSeed << 5;
+
+	nextReferenceWrite = (referenceSeed >> 8) % 4 == 0; // a quarter of the references are writes
+
+	if (referenceSeed % 16 == 0) {
+		nextMemoryReference = static_cast<int>(referenceSeed % size); // jump
+	}
+	else {
+		nextMemoryReference = (nextMemoryReference + 1) % size; // next KB
+	}
+}
+
+void Process::recordPageFault(bool major) {
+	if (major) {
+		numMajorFaults++;
+	}
+	else {
+		numMinorFaults++;
+	}
+}
+
+long long Process::getNumMemoryReferences() const {
+	return numMemoryReferences;
+}
+
+long long Process::getNumMinorFaults() const {
+	return numMinorFaults;
+}
+
+long long Process::getNumMajorFaults() const {
+	return numMajorFaults;
+}
+
+void Process::recordMemoryAccess(bool remote) {
+	if (remote) {
+		numRemoteAccesses++;
+	}
+	else {
+		numLocalAccesses++;
+	}
+}
+
+long long Process::getNumLocalAccesses() const {
+	return numLocalAccesses;
+}
+
+long long Process::getNumRemoteAccesses() const {
+	return numRemoteAccesses;
+}
+
+void Process::recordSwapIn(long long waitMicroseconds) {
+	numSwapIns++;
+	waitTime += waitMicroseconds;
+}
+
+long long Process::getNumSwapIns() const {
+	return numSwapIns;
+}
+
+long long Process::getWaitTime() const {
+	return waitTime;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <chrono>
 #include <string>
+#include <cstdint>
 
 class Process
 {
@@ -8,8 +9,37 @@ public:
 	Process();
 	Process(std::string name, int id, int totalInstructions, float memorySize, float pageSize);
 
+	// Everything but the name, fixed-size so a checkpoint can store it as is
+	struct State {
+		int32_t id;
+		int32_t parentID;
+		int32_t core;
+		int32_t finished;
+		int32_t currentInstruction;
+		int32_t totalInstructions;
+		float memorySize;
+		float pageSize;
+		int32_t nextMemoryReference;
+		int32_t nextReferenceWrite;
+		uint32_t referenceSeed;
+		int32_t reserved;
+		int64_t creationTime; // microseconds since the epoch
+		int64_t numMemoryReferences;
+		int64_t numMinorFaults;
+		int64_t numMajorFaults;
+		int64_t numLocalAccesses;
+		int64_t numRemoteAccesses;
+		int64_t numSwapIns;
+		int64_t waitTime;
+	};
+
+	Process(std::string name, const State& state); // restored from a checkpoint, continues exactly where the state was taken
+	State getState() const;
+
 	std::string getName() const;
 	int getID() const;
+	int getParentID() const; // -1 unless the process was cloned from another one
+	void setParentID(int parentID);
 	int getCurrentInstruction() const;
 	int getTotalInstructions() const;
 	int getRemainingInstructions() const;
@@ -22,9 +52,28 @@ public:
 
 	void execute(); // Executes one instruction
 
+	// Demand paging
+	int getNextMemoryReference() const; // Address (in KB) the next instruction touches
+	bool isNextReferenceWrite() const; // True if the next instruction writes its address
+	void recordPageFault(bool major); // Counts a page fault taken by the next instruction
+	long long getNumMemoryReferences() const;
+	long long getNumMinorFaults() const;
+	long long getNumMajorFaults() const;
+
+	// NUMA
+	void recordMemoryAccess(bool remote); // Counts a reference to memory on the core's own node or another one
+	long long getNumLocalAccesses() const;
+	long long getNumRemoteAccesses() const;
+
+	// Swap-in, a process dispatched without its memory waits while the memory manager brings it back
+	void recordSwapIn(long long waitMicroseconds); // Counts a swap-in and adds its latency to the wait time
+	long long getNumSwapIns() const;
+	long long getWaitTime() const; // Microseconds the process was held back from running
+
 private:
 	std::string processName;
 	int id;
+	int parentID;
 	int core;
 	std::string status;
 	std::chrono::system_clock::time_point creationTime;
@@ -35,5 +84,18 @@ private:
 	
 	float memorySize;
 	float pageSize;
+
+	int nextMemoryReference;
+	bool nextReferenceWrite;
+	unsigned int referenceSeed; // Per-process generator so every process has its own access pattern
+	long long numMemoryReferences;
+	long long numMinorFaults;
+	long long numMajorFaults;
+	long long numLocalAccesses;
+	long long numRemoteAccesses;
+	long long numSwapIns;
+	long long waitTime;
+
+	void generateNextMemoryReference();
 };
 